@@ -126,7 +126,23 @@ SOURCES += \
     src/widgets/settingspages/accountspage.cpp \
     src/widgets/settingspages/aboutpage.cpp \
     src/widgets/settingspages/moderationpage.cpp \
-    src/widgets/settingspages/logspage.cpp
+    src/widgets/settingspages/logspage.cpp \
+    src/widgets/settingspages/memorypage.cpp \
+    src/singletons/scrollbackmanager.cpp \
+    src/messages/coldmessagestore.cpp \
+    src/util/symbol.cpp \
+    src/twitch/twitchparsepipeline.cpp \
+    src/util/irctags.cpp \
+    src/twitch/twitchemotetag.cpp \
+    src/util/emotetable.cpp \
+    src/util/emojitrie.cpp \
+    src/messages/highlightengine.cpp \
+    src/util/messagetokenizer.cpp \
+    src/util/linkdetector.cpp \
+    src/twitch/twitchbadgeresolver.cpp \
+    src/twitch/twitchcheermotematcher.cpp \
+    src/messages/layouts/messagelayoutengine.cpp \
+    src/util/wordwidthcache.cpp
 
 HEADERS  += \
     src/precompiled_headers.hpp \
@@ -159,6 +175,7 @@ HEADERS  += \
     src/singletons/emotemanager.hpp \
     src/util/urlfetch.hpp \
     src/messages/messageparseargs.hpp \
+    src/messages/parsecontext.hpp \
     src/messages/messagebuilder.hpp \
     src/twitch/twitchmessagebuilder.hpp \
     src/widgets/titlebar.hpp \
@@ -188,7 +205,17 @@ HEADERS  += \
     src/widgets/splitcontainer.hpp \
     src/widgets/helper/droppreview.hpp \
     src/widgets/helper/splitcolumn.hpp \
-    src/util/irchelpers.hpp \
+    src/util/irctags.hpp \
+    src/twitch/twitchemotetag.hpp \
+    src/util/emotetable.hpp \
+    src/util/emojitrie.hpp \
+    src/messages/highlightengine.hpp \
+    src/util/messagetokenizer.hpp \
+    src/util/linkdetector.hpp \
+    src/twitch/twitchbadgeresolver.hpp \
+    src/twitch/twitchcheermotematcher.hpp \
+    src/messages/layouts/messagelayoutengine.hpp \
+    src/util/wordwidthcache.hpp \
     src/util/helpers.hpp \
     src/widgets/accountswitchwidget.hpp \
     src/widgets/accountswitchpopupwidget.hpp \
@@ -224,7 +251,13 @@ HEADERS  += \
     src/widgets/settingspages/accountspage.hpp \
     src/widgets/settingspages/aboutpage.hpp \
     src/widgets/settingspages/moderationpage.hpp \
-    src/widgets/settingspages/logspage.hpp
+    src/widgets/settingspages/logspage.hpp \
+    src/widgets/settingspages/memorypage.hpp \
+    src/singletons/scrollbackmanager.hpp \
+    src/messages/coldmessagestore.hpp \
+    src/util/arena.hpp \
+    src/util/symbol.hpp \
+    src/twitch/twitchparsepipeline.hpp
 
 
 PRECOMPILED_HEADER =
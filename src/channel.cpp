@@ -1,11 +1,14 @@
 #include "channel.hpp"
+#include "asyncexec.hpp"
 #include "debug/log.hpp"
 #include "logging/loggingmanager.hpp"
 #include "messages/message.hpp"
 #include "singletons/emotemanager.hpp"
 #include "singletons/ircmanager.hpp"
+#include "singletons/pathmanager.hpp"
 #include "singletons/windowmanager.hpp"
 
+#include <QDateTime>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -13,6 +16,7 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QTimer>
 
 using namespace chatterino::messages;
 
@@ -24,6 +28,10 @@ Channel::Channel(const QString &_name)
 {
 }
 
+Channel::~Channel()
+{
+}
+
 bool Channel::isEmpty() const
 {
     return false;
@@ -36,29 +44,79 @@ messages::LimitedQueueSnapshot<messages::MessagePtr> Channel::getMessageSnapshot
 
 void Channel::addMessage(MessagePtr message)
 {
-    MessagePtr deleted;
+    std::vector<MessagePtr> messages{message};
 
-    const QString &username = message->loginName;
+    this->addMessages(messages);
+}
 
-    if (!username.isEmpty()) {
-        // TODO: Add recent chatters display name. This should maybe be a setting
-        this->addRecentChatter(message);
+void Channel::addMessages(std::vector<messages::MessagePtr> &_messages)
+{
+    if (_messages.empty()) {
+        return;
     }
 
-    //    if (_loggingChannel.get() != nullptr) {
-    //        _loggingChannel->append(message);
-    //    }
+    for (const MessagePtr &message : _messages) {
+        if (!message->loginName.isEmpty()) {
+            // TODO: Add recent chatters display name. This should maybe be a setting
+            this->addRecentChatter(message);
+        }
+
+        //    if (_loggingChannel.get() != nullptr) {
+        //        _loggingChannel->append(message);
+        //    }
 
-    if (this->messages.pushBack(message, deleted)) {
-        messageRemovedFromStart(deleted);
+        this->approximateMessagesSize += message->getApproximateSize();
     }
 
-    this->messageAppended(message);
+    this->addedMessageCount += _messages.size();
+
+    std::vector<MessagePtr> deletedMessages;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex);
+
+        int64_t position =
+            this->firstPosition + (int64_t)this->messages.getSnapshot().getLength();
+
+        deletedMessages = this->messages.pushBack(_messages);
+
+        for (const MessagePtr &message : _messages) {
+            this->indexMessage(message, position++);
+        }
+
+        for (const MessagePtr &deleted : deletedMessages) {
+            this->unindexMessage(deleted, this->firstPosition++);
+        }
+    }
+
+    if (!deletedMessages.empty()) {
+        for (const MessagePtr &deleted : deletedMessages) {
+            this->approximateMessagesSize -= deleted->getApproximateSize();
+            this->storeRemovedMessage(deleted);
+        }
+
+        this->messagesRemovedFromStart(deletedMessages);
+    }
+
+    this->messagesAppended(_messages);
 }
 
 void Channel::addMessagesAtStart(std::vector<messages::MessagePtr> &_messages)
 {
-    std::vector<messages::MessagePtr> addedMessages = this->messages.pushFront(_messages);
+    std::vector<messages::MessagePtr> addedMessages;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex);
+
+        addedMessages = this->messages.pushFront(_messages);
+        this->firstPosition -= (int64_t)addedMessages.size();
+
+        for (size_t i = 0; i < addedMessages.size(); i++) {
+            this->indexMessage(addedMessages[i], this->firstPosition + (int64_t)i);
+        }
+    }
+
+    for (const MessagePtr &message : addedMessages) {
+        this->approximateMessagesSize += message->getApproximateSize();
+    }
 
     if (addedMessages.size() != 0) {
         this->messagesAddedAtStart(addedMessages);
@@ -67,11 +125,130 @@ void Channel::addMessagesAtStart(std::vector<messages::MessagePtr> &_messages)
 
 void Channel::replaceMessage(messages::MessagePtr message, messages::MessagePtr replacement)
 {
-    int index = this->messages.replaceItem(message, replacement);
+    size_t index;
+    MessagePtr replaced;
+    {
+        // look up and replace under the same lock, so the index can't move in between
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex);
 
-    if (index >= 0) {
-        this->messageReplaced((size_t)index, replacement);
+        auto it = this->positionsByMessage.find(message.get());
+
+        if (it == this->positionsByMessage.end()) {
+            return;
+        }
+
+        index = (size_t)(it.value() - this->firstPosition);
+
+        replaced = this->replaceIndexedMessage(index, replacement);
+
+        if (replaced == nullptr) {
+            return;
+        }
+    }
+
+    this->approximateMessagesSize += replacement->getApproximateSize();
+    this->approximateMessagesSize -= replaced->getApproximateSize();
+
+    this->messageReplaced(index, replacement);
+}
+
+void Channel::replaceMessage(size_t index, messages::MessagePtr replacement)
+{
+    MessagePtr message;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex);
+
+        message = this->replaceIndexedMessage(index, replacement);
+
+        if (message == nullptr) {
+            return;
+        }
     }
+
+    this->approximateMessagesSize += replacement->getApproximateSize();
+    this->approximateMessagesSize -= message->getApproximateSize();
+
+    this->messageReplaced(index, replacement);
+}
+
+MessagePtr Channel::replaceIndexedMessage(size_t index, const messages::MessagePtr &replacement)
+{
+    auto snapshot = this->messages.getSnapshot();
+
+    if (index >= snapshot.getLength()) {
+        return MessagePtr();
+    }
+
+    MessagePtr message = snapshot[index];
+
+    this->messages.replaceItem(index, replacement);
+
+    this->unindexMessage(message, this->firstPosition + (int64_t)index);
+    this->indexMessage(replacement, this->firstPosition + (int64_t)index);
+
+    return message;
+}
+
+int Channel::findMessageIndex(const QString &messageId)
+{
+    std::lock_guard<std::mutex> lock(this->messageIndexMutex);
+
+    auto it = this->positionsById.find(messageId);
+
+    if (it == this->positionsById.end()) {
+        return -1;
+    }
+
+    return (int)(it.value() - this->firstPosition);
+}
+
+MessagePtr Channel::findMessage(const QString &messageId)
+{
+    std::lock_guard<std::mutex> lock(this->messageIndexMutex);
+
+    auto it = this->positionsById.find(messageId);
+
+    if (it == this->positionsById.end()) {
+        return MessagePtr();
+    }
+
+    return this->messages.getSnapshot()[(size_t)(it.value() - this->firstPosition)];
+}
+
+void Channel::setMessageLimit(size_t limit)
+{
+    std::vector<MessagePtr> removedMessages;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex);
+
+        removedMessages = this->messages.setLimit(limit);
+
+        for (const MessagePtr &message : removedMessages) {
+            this->unindexMessage(message, this->firstPosition++);
+        }
+    }
+
+    for (const MessagePtr &message : removedMessages) {
+        this->approximateMessagesSize -= message->getApproximateSize();
+        this->storeRemovedMessage(message);
+    }
+
+    this->messageLimitChanged(limit);
+}
+
+size_t Channel::getMessageLimit()
+{
+    return this->messages.getLimit();
+}
+
+size_t Channel::getApproximateMessagesSize() const
+{
+    return this->approximateMessagesSize;
+}
+
+size_t Channel::takeAddedMessageCount()
+{
+    return this->addedMessageCount.exchange(0);
 }
 
 void Channel::addRecentChatter(const std::shared_ptr<messages::Message> &message)
@@ -80,7 +257,8 @@ void Channel::addRecentChatter(const std::shared_ptr<messages::Message> &message
 
     std::lock_guard<std::mutex> lock(this->recentChattersMutex);
 
-    this->recentChatters[message->loginName] = {message->displayName, message->localizedName};
+    this->recentChatters[message->loginName.toString()] = {message->displayName.toString(),
+                                                           message->localizedName.toString()};
 }
 
 std::vector<Channel::NameOptions> Channel::getUsernamesForCompletions()
@@ -97,6 +275,223 @@ std::vector<Channel::NameOptions> Channel::getUsernamesForCompletions()
     return names;
 }
 
+void Channel::loadColdMessages(
+    uint64_t cursor, size_t count,
+    std::function<void(uint64_t cursor, std::vector<MessagePtr> &messages, bool exhausted)>
+        callback)
+{
+    // keeps the channel alive until the messages were restored
+    std::shared_ptr<Channel> self = this->shared_from_this();
+    std::shared_ptr<ColdMessageStore> store = this->coldStore;
+
+    this->runInBackground([self, store, cursor, count, callback]() mutable {
+        std::vector<MessagePtr> messages;
+        uint64_t begin = cursor;
+        bool exhausted = true;
+
+        if (store) {
+            uint64_t storeBegin = store->getBegin();
+
+            begin = std::max(cursor - std::min<uint64_t>(cursor, count), storeBegin);
+            begin = std::min(begin, cursor);
+            exhausted = begin <= storeBegin;
+
+            std::vector<ColdMessageStore::Record> records = store->read(begin, cursor);
+            messages.reserve(records.size());
+
+            for (const ColdMessageStore::Record &record : records) {
+                MessagePtr message = self->restoreMessage(record.data);
+
+                if (message) {
+                    messages.push_back(message);
+                }
+            }
+        }
+
+        // the channel is only released on the gui thread
+        postToThread([ self = std::move(self), begin, messages = std::move(messages), exhausted,
+                       callback = std::move(callback) ]() mutable {
+            callback(begin, messages, exhausted);  //
+        });
+    });
+}
+
+bool Channel::hasColdStorage() const
+{
+    return this->coldStore != nullptr;
+}
+
+uint64_t Channel::getColdMessagesEnd()
+{
+    if (!this->coldStore) {
+        return 0;
+    }
+
+    return this->coldStore->getEnd();
+}
+
+void Channel::enableColdStorage()
+{
+    this->coldStore = std::make_shared<ColdMessageStore>(
+        singletons::PathManager::getInstance().historyFolderPath + "/" + this->name);
+}
+
+MessagePtr Channel::restoreMessage(const QByteArray &)
+{
+    return MessagePtr();
+}
+
+void Channel::runInBackground(std::function<void()> task)
+{
+    async_exec(task);
+}
+
+std::vector<MessagePtr> Channel::getMessagesFromUser(const util::Symbol &loginName)
+{
+    std::vector<MessagePtr> messages;
+
+    std::lock_guard<std::mutex> lock(this->messageIndexMutex);
+
+    auto it = this->positionsByUser.find(loginName);
+
+    if (it == this->positionsByUser.end()) {
+        return messages;
+    }
+
+    auto snapshot = this->messages.getSnapshot();
+    messages.reserve(it.value().size());
+
+    for (int64_t position : it.value()) {
+        messages.push_back(snapshot[(size_t)(position - this->firstPosition)]);
+    }
+
+    return messages;
+}
+
+void Channel::disableMessagesFromUser(const util::Symbol &loginName)
+{
+    for (const MessagePtr &message : this->getMessagesFromUser(loginName)) {
+        if (!message->hasFlags(Message::Timeout)) {
+            this->disableMessage(message);
+        }
+    }
+}
+
+void Channel::disableMessage(const MessagePtr &message)
+{
+    if (message->hasFlags(Message::Disabled)) {
+        return;
+    }
+
+    message->addFlags(Message::Disabled);
+    this->disabledMessages.push_back(message);
+
+    // bans often come in waves, only notify the views once per frame
+    if (!this->disabledMessagesQueued) {
+        this->disabledMessagesQueued = true;
+
+        std::weak_ptr<Channel> weak = this->shared_from_this();
+
+        QTimer::singleShot(1000 / 60, [weak] {
+            SharedChannel shared = weak.lock();
+
+            if (!shared) {
+                return;
+            }
+
+            std::vector<MessagePtr> messages;
+            std::swap(messages, shared->disabledMessages);
+            shared->disabledMessagesQueued = false;
+
+            shared->messagesDisabled(messages);
+        });
+    }
+}
+
+void Channel::indexMessage(const MessagePtr &message, int64_t position)
+{
+    this->positionsByMessage.insert(message.get(), position);
+
+    if (!message->getId().isEmpty()) {
+        this->positionsById.insert(message->getId(), position);
+    }
+
+    if (!message->loginName.isEmpty()) {
+        std::deque<int64_t> &positions = this->positionsByUser[message->loginName];
+
+        // messages are almost always added to the end or the start
+        if (positions.empty() || positions.back() < position) {
+            positions.push_back(position);
+        } else if (positions.front() > position) {
+            positions.push_front(position);
+        } else {
+            positions.insert(std::lower_bound(positions.begin(), positions.end(), position),
+                             position);
+        }
+    }
+}
+
+void Channel::unindexMessage(const MessagePtr &message, int64_t position)
+{
+    // the same message or id might have been added again later
+    auto it = this->positionsByMessage.find(message.get());
+
+    if (it != this->positionsByMessage.end() && it.value() == position) {
+        this->positionsByMessage.erase(it);
+    }
+
+    if (!message->getId().isEmpty()) {
+        auto idIt = this->positionsById.find(message->getId());
+
+        if (idIt != this->positionsById.end() && idIt.value() == position) {
+            this->positionsById.erase(idIt);
+        }
+    }
+
+    if (!message->loginName.isEmpty()) {
+        auto userIt = this->positionsByUser.find(message->loginName);
+
+        if (userIt == this->positionsByUser.end()) {
+            return;
+        }
+
+        std::deque<int64_t> &positions = userIt.value();
+
+        // messages are almost always removed from the start
+        if (!positions.empty() && positions.front() == position) {
+            positions.pop_front();
+        } else {
+            auto positionIt = std::lower_bound(positions.begin(), positions.end(), position);
+
+            if (positionIt != positions.end() && *positionIt == position) {
+                positions.erase(positionIt);
+            }
+        }
+
+        if (positions.empty()) {
+            this->positionsByUser.erase(userIt);
+        }
+    }
+}
+
+void Channel::storeRemovedMessage(const MessagePtr &message)
+{
+    // system messages aren't parsed from irc and can't be restored
+    if (!this->coldStore || message->getIrcData().isEmpty()) {
+        return;
+    }
+
+    // keyed by the time the message was sent, which differs from now for recent messages that
+    // are evicted right after they were fetched
+    qint64 timestamp = message->getSentTimestamp();
+
+    if (timestamp == 0) {
+        timestamp = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    this->coldStore->append(timestamp, message->getIrcData());
+}
+
 bool Channel::canSendMessage() const
 {
     return false;
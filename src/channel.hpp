@@ -1,16 +1,22 @@
 #pragma once
 
 #include "logging/loggingchannel.hpp"
+#include "messages/coldmessagestore.hpp"
 #include "messages/image.hpp"
 #include "messages/limitedqueue.hpp"
 #include "util/concurrentmap.hpp"
+#include "util/symbol.hpp"
 
+#include <QHash>
 #include <QMap>
 #include <QMutex>
 #include <QString>
 #include <QVector>
 #include <boost/signals2.hpp>
 
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <set>
 
@@ -23,20 +29,64 @@ class Channel : public std::enable_shared_from_this<Channel>
 {
 public:
     explicit Channel(const QString &_name);
+    virtual ~Channel();
 
-    boost::signals2::signal<void(messages::MessagePtr &)> messageRemovedFromStart;
-    boost::signals2::signal<void(messages::MessagePtr &)> messageAppended;
+    boost::signals2::signal<void(std::vector<messages::MessagePtr> &)> messagesRemovedFromStart;
+    boost::signals2::signal<void(std::vector<messages::MessagePtr> &)> messagesAppended;
     boost::signals2::signal<void(std::vector<messages::MessagePtr> &)> messagesAddedAtStart;
     boost::signals2::signal<void(size_t index, messages::MessagePtr &)> messageReplaced;
+    boost::signals2::signal<void(size_t limit)> messageLimitChanged;
+    // invoked at most once per frame with all messages disabled since the last invocation
+    boost::signals2::signal<void(const std::vector<messages::MessagePtr> &)> messagesDisabled;
 
     virtual bool isEmpty() const;
     messages::LimitedQueueSnapshot<messages::MessagePtr> getMessageSnapshot();
 
     void addMessage(messages::MessagePtr message);
+    // adds all messages at once, the signals are only invoked once
+    void addMessages(std::vector<messages::MessagePtr> &messages);
     void addMessagesAtStart(std::vector<messages::MessagePtr> &messages);
     void replaceMessage(messages::MessagePtr message, messages::MessagePtr replacement);
+    void replaceMessage(size_t index, messages::MessagePtr replacement);
     void addRecentChatter(const std::shared_ptr<messages::Message> &message);
 
+    // Message index
+    // Looks up messages by their twitch message id. Returns the index in the current message
+    // snapshot or -1 if the message isn't in the channel anymore.
+    int findMessageIndex(const QString &messageId);
+    messages::MessagePtr findMessage(const QString &messageId);
+
+    // Returns the messages of a user that are still in the channel, oldest first
+    std::vector<messages::MessagePtr> getMessagesFromUser(const util::Symbol &loginName);
+
+    // Disables the messages of a user, e.g. after a timeout
+    void disableMessagesFromUser(const util::Symbol &loginName);
+    void disableMessage(const messages::MessagePtr &message);
+
+    // set by the ScrollbackManager, removes messages from the start if the limit shrunk
+    void setMessageLimit(size_t limit);
+    size_t getMessageLimit();
+
+    // approximate amount of bytes used by the messages currently in the channel
+    size_t getApproximateMessagesSize() const;
+
+    // returns the amount of messages added since the last call
+    size_t takeAddedMessageCount();
+
+    // Cold storage
+    // Messages removed from the start are written to disk if the channel supports it.
+    // Restores up to `count` stored messages before `cursor` in the background. The callback is
+    // invoked on the gui thread with the restored messages, oldest first, the cursor of the
+    // oldest one and whether the cursor reached the oldest stored message. Use
+    // getColdMessagesEnd() as the first cursor.
+    void loadColdMessages(uint64_t cursor, size_t count,
+                          std::function<void(uint64_t cursor,
+                                             std::vector<messages::MessagePtr> &messages,
+                                             bool exhausted)>
+                              callback);
+    bool hasColdStorage() const;
+    uint64_t getColdMessagesEnd();
+
     struct NameOptions {
         QString displayName;
         QString localizedName;
@@ -54,9 +104,43 @@ public:
     virtual bool canSendMessage() const;
     virtual void sendMessage(const QString &message);
 
+protected:
+    void enableColdStorage();
+    // called on a background thread
+    virtual messages::MessagePtr restoreMessage(const QByteArray &ircData);
+    // runs the task that restores messages from the cold storage
+    virtual void runInBackground(std::function<void()> task);
+
 private:
+    void storeRemovedMessage(const messages::MessagePtr &message);
+
+    // guarded by messageIndexMutex
+    // returns the message that was replaced, or nullptr if the index is out of range
+    messages::MessagePtr replaceIndexedMessage(size_t index,
+                                               const messages::MessagePtr &replacement);
+    void indexMessage(const messages::MessagePtr &message, int64_t position);
+    void unindexMessage(const messages::MessagePtr &message, int64_t position);
+
+    // shared with the writes and reads that are still running in the background
+    std::shared_ptr<messages::ColdMessageStore> coldStore;
     messages::LimitedQueue<messages::MessagePtr> messages;
 
+    // Positions are counted from the first message that was ever added and don't change when
+    // messages are removed from the start. Index in the snapshot = position - firstPosition.
+    std::mutex messageIndexMutex;
+    int64_t firstPosition = 0;
+    QHash<QString, int64_t> positionsById;
+    QHash<const messages::Message *, int64_t> positionsByMessage;
+    // sorted positions of the messages of every user
+    QHash<util::Symbol, std::deque<int64_t>> positionsByUser;
+
+    // gui thread only
+    std::vector<messages::MessagePtr> disabledMessages;
+    bool disabledMessagesQueued = false;
+
+    std::atomic<size_t> approximateMessagesSize{0};
+    std::atomic<size_t> addedMessageCount{0};
+
     // std::shared_ptr<logging::Channel> loggingChannel;
 };
 
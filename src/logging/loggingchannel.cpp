@@ -37,7 +37,7 @@ void Channel::append(std::shared_ptr<messages::Message> message)
     str.append('[');
     str.append(now.toString("HH:mm:ss"));
     str.append("] ");
-    str.append(message->loginName);
+    str.append(message->loginName.toString());
     str.append(": ");
     str.append(message->getSearchText());
     str.append('\n');
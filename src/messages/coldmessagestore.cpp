@@ -0,0 +1,326 @@
+#include "messages/coldmessagestore.hpp"
+#include "asyncexec.hpp"
+#include "debug/log.hpp"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QSet>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace chatterino {
+namespace messages {
+
+namespace {
+
+// record layout: quint32 data size, qint64 timestamp, data
+const qint64 headerSize = sizeof(quint32) + sizeof(qint64);
+
+}  // namespace
+
+ColdMessageStore::ColdMessageStore(const QString &_parentDirectory)
+    : parentDirectory(_parentDirectory)
+{
+    // another chatterino instance or another store of the same channel may be writing to the
+    // parent directory, so the store only ever touches its own directory
+    static std::atomic<int> instanceCount{0};
+
+    QString prefix = this->parentDirectory + "/" +
+                     QString::number(QCoreApplication::applicationPid()) + "-";
+
+    if (QDir().mkpath(this->parentDirectory)) {
+        for (int i = 0; i < 100 && !this->createdDirectory; i++) {
+            QString directory = prefix + QString::number(instanceCount++);
+
+            // the lock is taken before the directory is created, so removeStaleSessions never
+            // sees the directory of a running session without its lock
+            std::unique_ptr<QLockFile> lockFile(new QLockFile(directory + ".lock"));
+            lockFile->setStaleLockTime(0);
+
+            if (!lockFile->tryLock(0)) {
+                continue;
+            }
+
+            // left behind by a crashed session with the same process id
+            QDir(directory).removeRecursively();
+
+            if (QDir().mkdir(directory)) {
+                this->directory = directory;
+                this->lockFile = std::move(lockFile);
+                this->createdDirectory = true;
+            }
+        }
+    }
+
+    if (!this->createdDirectory) {
+        debug::Log("[ColdMessageStore] Error creating directory in {}", this->parentDirectory);
+        this->valid = false;
+    }
+}
+
+ColdMessageStore::~ColdMessageStore()
+{
+    for (Segment &segment : this->segments) {
+        if (segment.map != nullptr) {
+            segment.file->unmap(segment.map);
+        }
+    }
+
+    this->segments.clear();
+
+    if (this->createdDirectory) {
+        QDir(this->directory).removeRecursively();
+
+        // removes the lock file
+        this->lockFile.reset();
+
+        // only succeeds if no other store uses it anymore
+        QDir().rmdir(this->parentDirectory);
+    }
+}
+
+void ColdMessageStore::removeStaleSessions(const QString &historyDirectory)
+{
+    QDir history(historyDirectory);
+
+    for (const QString &channel : history.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QDir channelDirectory(history.filePath(channel));
+
+        // sessions that crashed may have left a directory, a lock file or both behind
+        QSet<QString> sessions;
+
+        for (const QString &name : channelDirectory.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            sessions.insert(name);
+        }
+
+        for (const QString &name : channelDirectory.entryList({"*.lock"}, QDir::Files)) {
+            sessions.insert(name.left(name.length() - 5));
+        }
+
+        for (const QString &session : sessions) {
+            QString directory = channelDirectory.filePath(session);
+
+            // the lock of a running session can't be taken. The lock of a process that doesn't
+            // exist anymore is stale and taken over.
+            QLockFile lockFile(directory + ".lock");
+            lockFile.setStaleLockTime(0);
+
+            if (lockFile.tryLock(0)) {
+                QDir(directory).removeRecursively();
+                lockFile.unlock();
+            }
+        }
+
+        // only succeeds if no session is left
+        history.rmdir(channel);
+    }
+}
+
+void ColdMessageStore::append(qint64 timestamp, const QByteArray &data)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+
+        if (!this->valid) {
+            return;
+        }
+
+        this->queue.push_back(Record{timestamp, data});
+        this->nextSequence++;
+
+        if (this->flushQueued) {
+            return;
+        }
+
+        this->flushQueued = true;
+    }
+
+    std::shared_ptr<ColdMessageStore> self = this->shared_from_this();
+
+    async_exec([self] {
+        self->flush();  //
+    });
+}
+
+void ColdMessageStore::flush()
+{
+    std::lock_guard<std::mutex> segmentLock(this->segmentMutex);
+
+    while (true) {
+        std::vector<Record> batch;
+
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+
+            if (this->queue.empty() || !this->valid) {
+                this->flushQueued = false;
+                return;
+            }
+
+            // the records stay queued, and readable, until they were written
+            batch.assign(this->queue.begin(), this->queue.end());
+        }
+
+        size_t written = 0;
+        while (written < batch.size() && this->write(batch[written])) {
+            written++;
+        }
+
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+
+        this->queue.erase(this->queue.begin(), this->queue.begin() + written);
+
+        if (written < batch.size()) {
+            this->valid = false;
+            this->queue.clear();
+            this->writtenEnd = this->nextSequence;
+            this->flushQueued = false;
+            return;
+        }
+    }
+}
+
+bool ColdMessageStore::write(const Record &record)
+{
+    if (this->segments.empty() || this->segments.back().size >= segmentSize) {
+        if (!this->addSegment(record.timestamp)) {
+            return false;
+        }
+    }
+
+    Segment &segment = this->segments.back();
+
+    char header[headerSize];
+    quint32 dataSize = (quint32)record.data.size();
+    memcpy(header, &dataSize, sizeof(quint32));
+    memcpy(header + sizeof(quint32), &record.timestamp, sizeof(qint64));
+
+    segment.file->seek(segment.size);
+    if (segment.file->write(header, headerSize) != headerSize ||
+        segment.file->write(record.data) != record.data.size()) {
+        debug::Log("[ColdMessageStore] Error writing to {}", segment.file->fileName());
+        return false;
+    }
+
+    segment.offsets.push_back((quint32)segment.size);
+    segment.size += headerSize + record.data.size();
+    this->writtenEnd++;
+
+    return true;
+}
+
+uint64_t ColdMessageStore::getBegin()
+{
+    std::lock_guard<std::mutex> lock(this->segmentMutex);
+
+    return this->segments.empty() ? this->writtenEnd : this->segments.front().firstSequence;
+}
+
+uint64_t ColdMessageStore::getEnd()
+{
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+
+    return this->nextSequence;
+}
+
+std::vector<ColdMessageStore::Record> ColdMessageStore::read(uint64_t begin, uint64_t end)
+{
+    std::vector<Record> records;
+
+    std::lock_guard<std::mutex> segmentLock(this->segmentMutex);
+
+    for (Segment &segment : this->segments) {
+        uint64_t segmentEnd = segment.firstSequence + segment.offsets.size();
+
+        if (segmentEnd <= begin || segment.firstSequence >= end) {
+            continue;
+        }
+
+        const uchar *data = this->mapSegment(segment);
+
+        if (data == nullptr) {
+            continue;
+        }
+
+        uint64_t first = std::max(begin, segment.firstSequence) - segment.firstSequence;
+        uint64_t last = std::min(end, segmentEnd) - segment.firstSequence;
+
+        for (uint64_t i = first; i < last; i++) {
+            const uchar *record = data + segment.offsets[i];
+
+            quint32 dataSize;
+            Record item;
+            memcpy(&dataSize, record, sizeof(quint32));
+            memcpy(&item.timestamp, record + sizeof(quint32), sizeof(qint64));
+            item.data = QByteArray((const char *)record + headerSize, (int)dataSize);
+
+            records.push_back(std::move(item));
+        }
+    }
+
+    // the records that weren't written yet follow the written ones
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+
+    uint64_t first = std::max(begin, this->writtenEnd);
+    uint64_t last = std::min(end, this->writtenEnd + this->queue.size());
+
+    for (uint64_t i = first; i < last; i++) {
+        records.push_back(this->queue[i - this->writtenEnd]);
+    }
+
+    return records;
+}
+
+bool ColdMessageStore::addSegment(qint64 timestamp)
+{
+    if (this->segments.size() >= maxSegments) {
+        Segment &oldest = this->segments.front();
+
+        if (oldest.map != nullptr) {
+            oldest.file->unmap(oldest.map);
+        }
+        oldest.file->remove();
+        this->segments.pop_front();
+    }
+
+    Segment segment;
+    segment.file.reset(new QFile(this->directory + "/" + QString::number(timestamp) + ".seg"));
+    segment.firstSequence = this->writtenEnd;
+
+    if (!segment.file->open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        debug::Log("[ColdMessageStore] Error opening {}", segment.file->fileName());
+        return false;
+    }
+
+    this->segments.push_back(std::move(segment));
+
+    return true;
+}
+
+const uchar *ColdMessageStore::mapSegment(Segment &segment)
+{
+    // the segment that is being written to grows, map it again to see the new records
+    if (segment.map != nullptr && segment.mapSize == segment.size) {
+        return segment.map;
+    }
+
+    if (segment.map != nullptr) {
+        segment.file->unmap(segment.map);
+        segment.map = nullptr;
+    }
+
+    segment.file->flush();
+    segment.map = segment.file->map(0, segment.size);
+    segment.mapSize = segment.size;
+
+    if (segment.map == nullptr) {
+        debug::Log("[ColdMessageStore] Error mapping {}", segment.file->fileName());
+    }
+
+    return segment.map;
+}
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QLockFile>
+#include <QString>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+//
+// Append-only storage for the messages that were removed from a channel.
+//
+// - records are stored in segment files named after the timestamp of their first record
+// - every record gets a sequence number, sequence numbers of the stored records are
+//   [getBegin(), getEnd())
+// - append() only queues the record, the queued records are written in batches on the global
+//   thread pool. Queued records can already be read.
+// - segments are memory mapped for reading, so paging messages back in doesn't copy whole
+//   files into memory
+// - when there are more than `maxSegments` segments the oldest one is deleted
+// - the history is per session, every store writes to its own directory named after the process
+//   id and a counter, which is removed when the store is destroyed
+// - the store holds a lock file next to its directory while it exists, directories of sessions
+//   whose lock isn't held anymore (e.g. after a crash) are removed by removeStaleSessions()
+//
+class ColdMessageStore : public std::enable_shared_from_this<ColdMessageStore>
+{
+public:
+    // the store creates its own directory in `parentDirectory`
+    explicit ColdMessageStore(const QString &parentDirectory);
+    ~ColdMessageStore();
+
+    // removes the directories of sessions that ended without removing them, in every channel
+    // directory in `historyDirectory`. The directories of running sessions are kept.
+    static void removeStaleSessions(const QString &historyDirectory);
+
+    ColdMessageStore(const ColdMessageStore &) = delete;
+    ColdMessageStore &operator=(const ColdMessageStore &) = delete;
+
+    struct Record {
+        // milliseconds since epoch
+        qint64 timestamp;
+        QByteArray data;
+    };
+
+    // the store has to be owned by a shared_ptr, the queued write keeps it alive
+    void append(qint64 timestamp, const QByteArray &data);
+
+    uint64_t getBegin();
+    uint64_t getEnd();
+
+    // returns the records in [begin, end) that are still stored, oldest first
+    std::vector<Record> read(uint64_t begin, uint64_t end);
+
+private:
+    static const qint64 segmentSize = 4 * 1024 * 1024;
+    static const size_t maxSegments = 16;
+
+    struct Segment {
+        std::unique_ptr<QFile> file;
+        uint64_t firstSequence;
+
+        // offset of every record in the file
+        std::vector<quint32> offsets;
+        qint64 size = 0;
+
+        uchar *map = nullptr;
+        qint64 mapSize = 0;
+    };
+
+    // runs on the thread pool, writes the queued records
+    void flush();
+
+    // guarded by segmentMutex
+    bool write(const Record &record);
+    bool addSegment(qint64 timestamp);
+    const uchar *mapSegment(Segment &segment);
+
+    QString parentDirectory;
+    QString directory;
+    bool createdDirectory = false;
+    // held for as long as the store uses `directory`
+    std::unique_ptr<QLockFile> lockFile;
+
+    // lock order: segmentMutex before queueMutex
+    std::mutex segmentMutex;
+    std::deque<Segment> segments;
+    // sequence number of the first queued record
+    uint64_t writtenEnd = 0;
+
+    std::mutex queueMutex;
+    std::deque<Record> queue;
+    uint64_t nextSequence = 0;
+    bool flushQueued = false;
+    bool valid = true;
+};
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,243 @@
+#include "messages/highlightengine.hpp"
+#include "debug/log.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+
+namespace chatterino {
+namespace messages {
+
+namespace {
+
+// simple per code unit folding, the same thing Qt::CaseInsensitive compares with
+ushort fold(QChar character)
+{
+    ushort unicode = character.unicode();
+
+    if (unicode < 128) {
+        return unicode >= 'A' && unicode <= 'Z' ? unicode + ('a' - 'A') : unicode;
+    }
+
+    return character.toCaseFolded().unicode();
+}
+
+bool isWordCharacter(const QString &text, int index)
+{
+    return index >= 0 && index < text.size() && text.at(index).isLetterOrNumber();
+}
+
+}  // namespace
+
+HighlightEngine::HighlightEngine()
+    : nodes{Node{0, 0, 0, 0, 0, -1}}
+{
+}
+
+HighlightEngine::HighlightEngine(std::vector<HighlightPhrase> _phrases,
+                                 const QString &userBlacklist)
+    : phrases(std::move(_phrases))
+{
+    for (const QString &userName : userBlacklist.split("\n", QString::SkipEmptyParts)) {
+        this->userBlacklist.insert(userName.trimmed().toLower());
+    }
+
+    this->compile();
+}
+
+const std::vector<HighlightPhrase> &HighlightEngine::getPhrases() const
+{
+    return this->phrases;
+}
+
+bool HighlightEngine::isBlacklisted(const QString &userName) const
+{
+    return !this->userBlacklist.isEmpty() && this->userBlacklist.contains(userName.toLower());
+}
+
+HighlightEngine::Result HighlightEngine::match(const QString &text) const
+{
+    Result result;
+
+    // plain phrases
+    if (this->nodes[0].edgeCount != 0) {
+        int node = 0;
+
+        for (int i = 0; i < text.size(); i++) {
+            ushort key = fold(text.at(i));
+            int next;
+
+            while ((next = this->findEdge(node, key)) == -1 && node != 0) {
+                node = this->nodes[node].fail;
+            }
+
+            node = next == -1 ? 0 : next;
+
+            int output = this->nodes[node].outputCount != 0 ? node : this->nodes[node].outputLink;
+
+            for (; output != -1; output = this->nodes[output].outputLink) {
+                const Node &outputNode = this->nodes[output];
+
+                for (int j = 0; j < outputNode.outputCount; j++) {
+                    int phrase = this->outputs[outputNode.firstOutput + j];
+
+                    if (this->phrases[phrase].wholeWord) {
+                        int start = i - this->phrases[phrase].key.size() + 1;
+
+                        if (isWordCharacter(text, start - 1) || isWordCharacter(text, i + 1)) {
+                            continue;
+                        }
+                    }
+
+                    this->addMatch(result, phrase);
+                }
+            }
+        }
+    }
+
+    // regex phrases
+    for (const auto &regex : this->regexes) {
+        if (regex.second.match(text).hasMatch()) {
+            this->addMatch(result, regex.first);
+        }
+    }
+
+    return result;
+}
+
+void HighlightEngine::compile()
+{
+    // build the trie with maps first, then flatten it so the edges of a node are next to each
+    // other and sorted
+    std::vector<std::map<ushort, int>> children(1);
+    std::vector<std::vector<int>> nodeOutputs(1);
+
+    for (int phrase = 0; phrase < int(this->phrases.size()); phrase++) {
+        const HighlightPhrase &highlight = this->phrases[phrase];
+
+        // an empty key would highlight every message
+        if (highlight.key.isEmpty()) {
+            continue;
+        }
+
+        if (highlight.regex) {
+            QString pattern = highlight.key;
+
+            if (highlight.wholeWord) {
+                pattern = "\\b(?:" + pattern + ")\\b";
+            }
+
+            QRegularExpression regex(pattern, QRegularExpression::CaseInsensitiveOption |
+                                                  QRegularExpression::UseUnicodePropertiesOption);
+
+            if (!regex.isValid()) {
+                debug::Log("[HighlightEngine] Invalid regex {}: {}", highlight.key,
+                           regex.errorString());
+                continue;
+            }
+
+            regex.optimize();
+            this->regexes.emplace_back(phrase, std::move(regex));
+            continue;
+        }
+
+        int node = 0;
+
+        for (QChar character : highlight.key) {
+            ushort key = fold(character);
+            auto it = children[node].find(key);
+
+            if (it != children[node].end()) {
+                node = it->second;
+            } else {
+                int child = int(children.size());
+                children[node][key] = child;
+                children.emplace_back();
+                nodeOutputs.emplace_back();
+                node = child;
+            }
+        }
+
+        nodeOutputs[node].push_back(phrase);
+    }
+
+    this->nodes.assign(children.size(), Node{0, 0, 0, 0, 0, -1});
+
+    for (int node = 0; node < int(children.size()); node++) {
+        Node &current = this->nodes[node];
+
+        current.firstEdge = int(this->edgeKeys.size());
+        current.edgeCount = int(children[node].size());
+
+        for (const auto &child : children[node]) {
+            this->edgeKeys.push_back(child.first);
+            this->edgeTargets.push_back(child.second);
+        }
+
+        current.firstOutput = int(this->outputs.size());
+        current.outputCount = int(nodeOutputs[node].size());
+
+        this->outputs.insert(this->outputs.end(), nodeOutputs[node].begin(),
+                             nodeOutputs[node].end());
+    }
+
+    // fail and output links, breadth first so the links of shorter nodes are done first
+    std::deque<int> queue;
+
+    for (const auto &child : children[0]) {
+        queue.push_back(child.second);
+    }
+
+    while (!queue.empty()) {
+        int node = queue.front();
+        queue.pop_front();
+
+        for (const auto &child : children[node]) {
+            int fail = this->nodes[node].fail;
+            int next;
+
+            while ((next = this->findEdge(fail, child.first)) == -1 && fail != 0) {
+                fail = this->nodes[fail].fail;
+            }
+
+            Node &childNode = this->nodes[child.second];
+
+            childNode.fail = next == -1 ? 0 : next;
+            childNode.outputLink = this->nodes[childNode.fail].outputCount != 0
+                                       ? childNode.fail
+                                       : this->nodes[childNode.fail].outputLink;
+
+            queue.push_back(child.second);
+        }
+    }
+}
+
+int HighlightEngine::findEdge(int node, ushort key) const
+{
+    auto keysBegin = this->edgeKeys.begin() + this->nodes[node].firstEdge;
+    auto keysEnd = keysBegin + this->nodes[node].edgeCount;
+    auto it = std::lower_bound(keysBegin, keysEnd, key);
+
+    if (it == keysEnd || *it != key) {
+        return -1;
+    }
+
+    return this->edgeTargets[it - this->edgeKeys.begin()];
+}
+
+void HighlightEngine::addMatch(Result &result, int phrase) const
+{
+    if (std::find(result.phrases.begin(), result.phrases.end(), phrase) != result.phrases.end()) {
+        return;
+    }
+
+    const HighlightPhrase &highlight = this->phrases[phrase];
+
+    result.highlighted = true;
+    result.sound |= highlight.sound;
+    result.alert |= highlight.alert;
+    result.phrases.push_back(phrase);
+}
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "messages/highlightphrase.hpp"
+
+#include <QRegularExpression>
+#include <QSet>
+#include <QString>
+
+#include <boost/container/small_vector.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+//
+// Highlight phrases and the user blacklist compiled into one immutable matcher
+//
+// - plain phrases are folded into one case insensitive Aho-Corasick automaton, so a message is
+//   scanned once no matter how many phrases there are
+// - regex phrases are compiled once and run one after another
+// - whole word phrases only count if they are not surrounded by letters or digits
+// - the blacklist is a hash set of the lower case user names
+//
+// The engine is rebuilt by the SettingManager whenever one of the highlight settings changes and
+// is never modified afterwards, so it can be used from any thread.
+//
+class HighlightEngine
+{
+public:
+    struct Result {
+        bool highlighted = false;
+        bool sound = false;
+        bool alert = false;
+
+        // indices into getPhrases(), each phrase at most once
+        boost::container::small_vector<int, 4> phrases;
+    };
+
+    HighlightEngine();
+    HighlightEngine(std::vector<HighlightPhrase> phrases, const QString &userBlacklist);
+
+    const std::vector<HighlightPhrase> &getPhrases() const;
+
+    bool isBlacklisted(const QString &userName) const;
+
+    Result match(const QString &text) const;
+
+private:
+    struct Node {
+        int firstEdge;
+        int edgeCount;
+
+        // longest proper suffix of this node that is also in the automaton
+        int fail;
+
+        // phrases ending at this node are outputs[firstOutput, firstOutput + outputCount)
+        int firstOutput;
+        int outputCount;
+
+        // next node on the fail chain that has outputs, -1 if none
+        int outputLink;
+    };
+
+    void compile();
+    int findEdge(int node, ushort key) const;
+    void addMatch(Result &result, int phrase) const;
+
+    std::vector<HighlightPhrase> phrases;
+    QSet<QString> userBlacklist;
+
+    std::vector<Node> nodes;
+    std::vector<ushort> edgeKeys;
+    std::vector<int> edgeTargets;
+    std::vector<int> outputs;
+
+    std::vector<std::pair<int, QRegularExpression>> regexes;
+};
+
+}  // namespace messages
+}  // namespace chatterino
@@ -13,10 +13,16 @@ struct HighlightPhrase {
     bool sound;
     bool alert;
 
+    // the key is a regular expression instead of a plain phrase
+    bool regex = false;
+
+    // only matches if the key is not part of a longer word
+    bool wholeWord = false;
+
     bool operator==(const HighlightPhrase &rhs) const
     {
-        return std::tie(this->key, this->sound, this->alert) ==
-               std::tie(rhs.key, rhs.sound, rhs.alert);
+        return std::tie(this->key, this->sound, this->alert, this->regex, this->wholeWord) ==
+               std::tie(rhs.key, rhs.sound, rhs.alert, rhs.regex, rhs.wholeWord);
     }
 };
 }  // namespace messages
@@ -35,6 +41,8 @@ struct Serialize<chatterino::messages::HighlightPhrase> {
         AddMember(ret, "key", value.key, a);
         AddMember(ret, "alert", value.alert, a);
         AddMember(ret, "sound", value.sound, a);
+        AddMember(ret, "regex", value.regex, a);
+        AddMember(ret, "wholeWord", value.wholeWord, a);
 
         return ret;
     }
@@ -70,6 +78,20 @@ struct Deserialize<chatterino::messages::HighlightPhrase> {
             }
         }
 
+        if (value.HasMember("regex")) {
+            const rapidjson::Value &regex = value["regex"];
+            if (regex.IsBool()) {
+                ret.regex = regex.GetBool();
+            }
+        }
+
+        if (value.HasMember("wholeWord")) {
+            const rapidjson::Value &wholeWord = value["wholeWord"];
+            if (wholeWord.IsBool()) {
+                ret.wholeWord = wholeWord.GetBool();
+            }
+        }
+
         return ret;
     }
 };
@@ -11,6 +11,7 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QThread>
 #include <QTimer>
 
 #include <functional>
@@ -23,25 +24,41 @@ Image::Image(const QString &url, qreal scale, const QString &name, const QString
              const QMargins &margin, bool isHat)
     : currentPixmap(nullptr)
     , url(url)
-    , name(name)
-    , tooltip(tooltip)
+    , name(util::Symbol(name))
+    , tooltip(util::Symbol(tooltip))
     , margin(margin)
     , ishat(isHat)
     , scale(scale)
     , isLoading(false)
 {
+    this->moveToGuiThread();
 }
 
 Image::Image(QPixmap *image, qreal scale, const QString &name, const QString &tooltip,
              const QMargins &margin, bool isHat)
     : currentPixmap(image)
-    , name(name)
-    , tooltip(tooltip)
+    , name(util::Symbol(name))
+    , tooltip(util::Symbol(tooltip))
     , margin(margin)
     , ishat(isHat)
     , scale(scale)
     , isLoading(true)
 {
+    if (image != nullptr) {
+        this->width = image->width();
+        this->height = image->height();
+    }
+
+    this->moveToGuiThread();
+}
+
+void Image::moveToGuiThread()
+{
+    // Emotes are created by the message parser threads. The image is loaded with this as the
+    // caller of the network request, so it has to live on a thread with an event loop.
+    if (QThread::currentThread() != qApp->thread()) {
+        this->moveToThread(qApp->thread());
+    }
 }
 
 void Image::loadImage()
@@ -65,6 +82,8 @@ void Image::loadImage()
                 if (first) {
                     first = false;
                     lli->currentPixmap = pixmap;
+                    lli->width = pixmap->width();
+                    lli->height = pixmap->height();
                 }
 
                 chatterino::messages::Image::FrameData data;
@@ -128,12 +147,12 @@ const QString &Image::getUrl() const
     return this->url;
 }
 
-const QString &Image::getName() const
+const util::Symbol &Image::getName() const
 {
     return this->name;
 }
 
-const QString &Image::getTooltip() const
+const util::Symbol &Image::getTooltip() const
 {
     return this->tooltip;
 }
@@ -155,10 +174,7 @@ bool Image::isHat() const
 
 int Image::getWidth() const
 {
-    if (this->currentPixmap == nullptr) {
-        return 16;
-    }
-    return this->currentPixmap->width();
+    return this->width.load();
 }
 
 int Image::getScaledWidth() const
@@ -168,10 +184,7 @@ int Image::getScaledWidth() const
 
 int Image::getHeight() const
 {
-    if (this->currentPixmap == nullptr) {
-        return 16;
-    }
-    return this->currentPixmap->height();
+    return this->height.load();
 }
 
 int Image::getScaledHeight() const
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "util/symbol.hpp"
+
 #include <QPixmap>
 #include <QString>
 
 #include <boost/noncopyable.hpp>
 
+#include <atomic>
+
 namespace chatterino {
 namespace messages {
 
@@ -24,11 +28,14 @@ public:
     const QPixmap *getPixmap();
     qreal getScale() const;
     const QString &getUrl() const;
-    const QString &getName() const;
-    const QString &getTooltip() const;
+    const util::Symbol &getName() const;
+    const util::Symbol &getTooltip() const;
     const QMargins &getMargin() const;
     bool isAnimated() const;
     bool isHat() const;
+
+    // the size of the first frame, 16x16 until it is loaded. Safe to call from any thread, the
+    // messages are laid out on worker threads
     int getWidth() const;
     int getScaledWidth() const;
     int getHeight() const;
@@ -42,12 +49,14 @@ private:
 
     QPixmap *currentPixmap;
     std::vector<FrameData> allFrames;
+    std::atomic<int> width{16};
+    std::atomic<int> height{16};
     int currentFrame = 0;
     int currentFrameOffset = 0;
 
     QString url;
-    QString name;
-    QString tooltip;
+    util::Symbol name;
+    util::Symbol tooltip;
     bool animated = false;
     QMargins margin;
     bool ishat;
@@ -55,6 +64,7 @@ private:
 
     bool isLoading;
 
+    void moveToGuiThread();
     void loadImage();
     void gifUpdateTimout();
 };
@@ -1,4 +1,5 @@
 #include "messages/layouts/messagelayout.hpp"
+#include "messages/layouts/messagelayoutengine.hpp"
 #include "singletons/emotemanager.hpp"
 #include "singletons/settingsmanager.hpp"
 
@@ -8,19 +9,30 @@
 #include <QThread>
 #include <QtGlobal>
 
-#define MARGIN_LEFT (int)(8 * this->scale)
-#define MARGIN_RIGHT (int)(8 * this->scale)
-#define MARGIN_TOP (int)(4 * this->scale)
-#define MARGIN_BOTTOM (int)(4 * this->scale)
 #define COMPACT_EMOTES_OFFSET 6
 
 namespace chatterino {
 namespace messages {
 namespace layouts {
 
+bool MessageLayout::Parameters::operator==(const Parameters &other) const
+{
+    return this->width == other.width && this->scale == other.scale &&
+           this->fontGeneration == other.fontGeneration &&
+           this->emoteGeneration == other.emoteGeneration && this->wordTypes == other.wordTypes &&
+           this->emoteQuality == other.emoteQuality &&
+           this->timestampFormat == other.timestampFormat;
+}
+
+bool MessageLayout::Parameters::operator!=(const Parameters &other) const
+{
+    return !(*this == other);
+}
+
 MessageLayout::MessageLayout(MessagePtr _message)
     : message(_message)
     , buffer(nullptr)
+    , latestRequest(std::make_shared<std::atomic<int>>(0))
 {
     if (_message->hasFlags(Message::Collapsed)) {
         this->addFlags(MessageLayout::Collapsed);
@@ -35,7 +47,7 @@ Message *MessageLayout::getMessage()
 // Height
 int MessageLayout::getHeight() const
 {
-    return container.getHeight();
+    return this->height;
 }
 
 // Flags
@@ -63,97 +75,120 @@ void MessageLayout::removeFlags(Flags _flags)
 // return true if redraw is required
 bool MessageLayout::layout(int width, float scale)
 {
-    auto &emoteManager = singletons::EmoteManager::getInstance();
-
-    bool layoutRequired = false;
-
-    // check if width changed
-    bool widthChanged = width != this->currentLayoutWidth;
-    layoutRequired |= widthChanged;
-    this->currentLayoutWidth = width;
-
-    // check if emotes changed
-    bool imagesChanged = this->emoteGeneration != emoteManager.getGeneration();
-    layoutRequired |= imagesChanged;
-    this->emoteGeneration = emoteManager.getGeneration();
-
-    // check if text changed
-    bool textChanged =
-        this->fontGeneration != singletons::FontManager::getInstance().getGeneration();
-    layoutRequired |= textChanged;
-    this->fontGeneration = singletons::FontManager::getInstance().getGeneration();
-
-    // check if work mask changed
-    bool wordMaskChanged =
-        this->currentWordTypes != singletons::SettingManager::getInstance().getWordTypeMask();
-    layoutRequired |= wordMaskChanged;
-    this->currentWordTypes = singletons::SettingManager::getInstance().getWordTypeMask();
-
-    // check if dpi changed
-    bool scaleChanged = this->scale != scale;
-    layoutRequired |= scaleChanged;
-    this->scale = scale;
-    imagesChanged |= scaleChanged;
-    textChanged |= scaleChanged;
-
-    // update word sizes if needed
-    if (imagesChanged) {
-        // fourtf: update images
-        this->addFlags(MessageLayout::RequiresBufferUpdate);
+    auto &settings = singletons::SettingManager::getInstance();
+
+    Parameters parameters;
+    parameters.width = width;
+    parameters.scale = scale;
+    parameters.fontGeneration = singletons::FontManager::getInstance().getGeneration();
+    parameters.emoteGeneration = singletons::EmoteManager::getInstance().getGeneration();
+    parameters.wordTypes = settings.getWordTypeMask();
+    parameters.emoteQuality = settings.preferredEmoteQuality;
+    parameters.timestampFormat = settings.timestampFormat;
+
+    bool redrawRequired = this->containerChanged;
+    this->containerChanged = false;
+
+    // the layout is up to date or will be soon
+    if (this->container != nullptr && parameters == this->containerParameters) {
+        return redrawRequired;
     }
-    if (textChanged) {
-        // fourtf: update text
-        this->addFlags(MessageLayout::RequiresBufferUpdate);
+
+    if (this->requestPending && parameters == this->requestedParameters) {
+        return redrawRequired;
     }
-    if (widthChanged || wordMaskChanged) {
-        this->deleteBuffer();
+
+    if (this->container == nullptr) {
+        // placeholder, one line of text and the margins of the container
+        auto &metrics = singletons::FontManager::getInstance().getFontMetrics(FontStyle::Medium,
+                                                                             scale);
+        this->height = metrics.height() + int(8 * scale);
     }
 
-    // return if no layout is required
-    if (!layoutRequired) {
-        return false;
+    this->requestedParameters = parameters;
+    this->requestPending = true;
+
+    MessageLayoutEngine::Request request;
+    request.layout = this->shared_from_this();
+    request.message = this->message;
+    request.parameters = parameters;
+    request.id = ++*this->latestRequest;
+    request.latestId = this->latestRequest;
+
+    MessageLayoutEngine::getInstance().push(std::move(request));
+
+    return redrawRequired;
+}
+
+std::shared_ptr<const MessageLayoutContainer> MessageLayout::createContainer(
+    Message &message, const Parameters &parameters)
+{
+    auto container = std::make_shared<MessageLayoutContainer>();
+    container->width = parameters.width;
+    container->scale = parameters.scale;
+    container->emoteQuality = parameters.emoteQuality;
+    container->timestampFormat = parameters.timestampFormat;
+
+    for (MessageElement *element : message.getElements()) {
+        element->addToContainer(*container, MessageElement::Default);
     }
 
-    this->actuallyLayout(width);
-    this->invalidateBuffer();
+    container->finish();
 
-    return true;
+    return container;
 }
 
-void MessageLayout::actuallyLayout(int width)
+void MessageLayout::setContainer(int requestId, const Parameters &parameters,
+                                 std::shared_ptr<const MessageLayoutContainer> _container)
 {
-    this->container.clear();
-    this->container.width = width;
-    this->container.scale = this->scale;
+    bool isLatest = requestId == this->latestRequest->load();
+
+    if (!isLatest && this->container != nullptr) {
+        return;
+    }
 
-    for (const std::unique_ptr<MessageElement> &element : this->message->getElements()) {
-        element->addToContainer(this->container, MessageElement::Default);
+    if (isLatest) {
+        this->requestPending = false;
     }
 
-    if (this->height != this->container.getHeight()) {
+    // the buffer is only kept if it has the same size
+    if (this->container == nullptr || this->container->width != _container->width ||
+        this->container->getHeight() != _container->getHeight()) {
         this->deleteBuffer();
+    } else {
+        this->invalidateBuffer();
     }
 
-    this->container.finish();
-    this->height = this->container.getHeight();
+    this->container = std::move(_container);
+    this->containerParameters = parameters;
+    this->containerChanged = true;
+    this->height = this->container->getHeight();
 }
 
 // Painting
 void MessageLayout::paint(QPainter &painter, int y, int messageIndex, Selection &selection)
 {
-    QPixmap *pixmap = this->buffer.get();
     singletons::ThemeManager &themeManager = singletons::ThemeManager::getInstance();
 
+    if (this->container == nullptr) {
+        painter.fillRect(0, y, this->requestedParameters.width, this->height,
+                         themeManager.messages.backgrounds.regular);
+        return;
+    }
+
+    QPixmap *pixmap = this->buffer.get();
+
     // create new buffer if required
     if (!pixmap) {
 #ifdef Q_OS_MACOS
 
-        pixmap =
-            new QPixmap((int)(this->container.getWidth() * painter.device()->devicePixelRatioF()),
-                        (int)(this->container.getHeight() * painter.device()->devicePixelRatioF()));
+        qreal ratio = painter.device()->devicePixelRatioF();
+
+        pixmap = new QPixmap((int)(this->container->width * ratio),
+                             (int)(this->container->getHeight() * ratio));
         pixmap->setDevicePixelRatio(painter.device()->devicePixelRatioF());
 #else
-        pixmap = new QPixmap(this->container.width, std::max(16, this->container.getHeight()));
+        pixmap = new QPixmap(this->container->width, std::max(16, this->container->getHeight()));
 #endif
 
         this->buffer = std::shared_ptr<QPixmap>(pixmap);
@@ -173,7 +208,7 @@ void MessageLayout::paint(QPainter &painter, int y, int messageIndex, Selection
     }
 
     // draw gif emotes
-    this->container.paintAnimatedElements(painter, y);
+    this->container->paintAnimatedElements(painter, y);
 
     this->bufferValid = true;
 }
@@ -193,11 +228,11 @@ void MessageLayout::updateBuffer(QPixmap *buffer, int messageIndex, Selection &s
 
     // draw selection
     if (!selection.isEmpty()) {
-        this->container.paintSelection(painter, messageIndex, selection);
+        this->container->paintSelection(painter, messageIndex, selection);
     }
 
     // draw message
-    this->container.paintElements(painter);
+    this->container->paintElements(painter);
 
 #ifdef OHHEYITSFOURTF
     // debug
@@ -208,7 +243,7 @@ void MessageLayout::updateBuffer(QPixmap *buffer, int messageIndex, Selection &s
     QTextOption option;
     option.setAlignment(Qt::AlignRight | Qt::AlignTop);
 
-    painter.drawText(QRectF(1, 1, this->container.width - 3, 1000),
+    painter.drawText(QRectF(1, 1, this->container->width - 3, 1000),
                      QString::number(++this->bufferUpdatedCount), option);
 #endif
 }
@@ -223,6 +258,22 @@ void MessageLayout::deleteBuffer()
     this->buffer = nullptr;
 }
 
+// Memory
+size_t MessageLayout::getApproximateSize() const
+{
+    size_t size = sizeof(MessageLayout);
+
+    if (this->container != nullptr) {
+        size += sizeof(MessageLayoutContainer) + this->container->getApproximateSize();
+    }
+
+    if (this->buffer) {
+        size += (size_t)this->buffer->width() * this->buffer->height() * this->buffer->depth() / 8;
+    }
+
+    return size;
+}
+
 // Elements
 //    assert(QThread::currentThread() == QApplication::instance()->thread());
 
@@ -231,8 +282,12 @@ void MessageLayout::deleteBuffer()
 // fourtf: this should return a MessageLayoutItem
 const MessageLayoutElement *MessageLayout::getElementAt(QPoint point)
 {
+    if (this->container == nullptr) {
+        return nullptr;
+    }
+
     // go through all words and return the first one that contains the point.
-    return this->container.getElementAt(point);
+    return this->container->getElementAt(point);
 }
 
 // XXX(pajlada): This is probably not the optimal way to calculate this
@@ -8,6 +8,7 @@
 #include <QPixmap>
 
 #include <boost/noncopyable.hpp>
+#include <atomic>
 #include <cinttypes>
 #include <memory>
 
@@ -19,11 +20,32 @@ class MessageLayout;
 typedef std::shared_ptr<MessageLayout> MessageLayoutPtr;
 typedef uint8_t MessageLayoutFlagsType;
 
-class MessageLayout : boost::noncopyable
+//
+// Layout of a message in one ChannelView
+//
+// - the layout itself is computed on a worker thread by the MessageLayoutEngine, layout() only
+//   requests it and swaps in the result once it arrived
+// - until then the previous layout is shown, or an empty placeholder one line high
+//
+class MessageLayout : boost::noncopyable, public std::enable_shared_from_this<MessageLayout>
 {
 public:
     enum Flags : MessageLayoutFlagsType { Collapsed, RequiresBufferUpdate, RequiresLayout };
 
+    // everything a layout depends on, taken on the gui thread
+    struct Parameters {
+        int width = -1;
+        float scale = -1;
+        int fontGeneration = -1;
+        int emoteGeneration = -1;
+        MessageElement::Flags wordTypes = MessageElement::None;
+        int emoteQuality = 0;
+        QString timestampFormat;
+
+        bool operator==(const Parameters &other) const;
+        bool operator!=(const Parameters &other) const;
+    };
+
     MessageLayout(MessagePtr message);
 
     Message *getMessage();
@@ -38,8 +60,19 @@ public:
     void removeFlags(Flags flags);
 
     // Layout
+    // requests a new layout if something it depends on changed, returns true if a finished
+    // layout was swapped in since the last call
     bool layout(int width, float scale);
 
+    // runs on the layout threads
+    static std::shared_ptr<const MessageLayoutContainer> createContainer(
+        Message &message, const Parameters &parameters);
+
+    // called on the gui thread by the MessageLayoutEngine, results of outdated requests are only
+    // used if there is no layout to show yet
+    void setContainer(int requestId, const Parameters &parameters,
+                      std::shared_ptr<const MessageLayoutContainer> container);
+
     // Painting
     void paint(QPainter &painter, int y, int messageIndex, Selection &selection);
     void invalidateBuffer();
@@ -53,28 +86,36 @@ public:
     // Misc
     bool isDisabled() const;
 
+    // Memory
+    // Rough amount of bytes used by the layout and its buffer, the message is not included
+    size_t getApproximateSize() const;
+
 private:
     // variables
     MessagePtr message;
-    MessageLayoutContainer container;
     std::shared_ptr<QPixmap> buffer = nullptr;
     bool bufferValid = false;
     Flags flags;
 
+    // null until the first layout arrived
+    std::shared_ptr<const MessageLayoutContainer> container;
+    Parameters containerParameters;
+    bool containerChanged = false;
+
+    // the height of the container or of the placeholder
     int height = 0;
 
-    int currentLayoutWidth = -1;
-    int fontGeneration = -1;
-    int emoteGeneration = -1;
-    float scale = -1;
-    unsigned int bufferUpdatedCount = 0;
+    Parameters requestedParameters;
+    bool requestPending = false;
 
-    MessageElement::Flags currentWordTypes = MessageElement::None;
+    // id of the newest request, read by the layout threads to skip outdated requests
+    std::shared_ptr<std::atomic<int>> latestRequest;
+
+    unsigned int bufferUpdatedCount = 0;
 
     int collapsedHeight = 32;
 
     // methods
-    void actuallyLayout(int width);
     void updateBuffer(QPixmap *pixmap, int messageIndex, Selection &selection);
 };
 
@@ -28,6 +28,7 @@ int MessageLayoutContainer::getHeight() const
 void MessageLayoutContainer::clear()
 {
     this->elements.clear();
+    this->keptAlive.clear();
 
     this->height = 0;
     this->line = 0;
@@ -129,9 +130,9 @@ void MessageLayoutContainer::finish()
     }
 }
 
-MessageLayoutElement *MessageLayoutContainer::getElementAt(QPoint point)
+MessageLayoutElement *MessageLayoutContainer::getElementAt(QPoint point) const
 {
-    for (std::unique_ptr<MessageLayoutElement> &element : this->elements) {
+    for (const std::unique_ptr<MessageLayoutElement> &element : this->elements) {
         if (element->getRect().contains(point)) {
             return element.get();
         }
@@ -140,15 +141,27 @@ MessageLayoutElement *MessageLayoutContainer::getElementAt(QPoint point)
     return nullptr;
 }
 
+void MessageLayoutContainer::keepAlive(std::shared_ptr<const void> object)
+{
+    this->keptAlive.push_back(std::move(object));
+}
+
+size_t MessageLayoutContainer::getApproximateSize() const
+{
+    // text elements are the biggest layout elements
+    return this->elements.capacity() * sizeof(std::unique_ptr<MessageLayoutElement>) +
+           this->elements.size() * sizeof(TextLayoutElement);
+}
+
 // painting
-void MessageLayoutContainer::paintElements(QPainter &painter)
+void MessageLayoutContainer::paintElements(QPainter &painter) const
 {
     for (const std::unique_ptr<MessageLayoutElement> &element : this->elements) {
         element->paint(painter);
     }
 }
 
-void MessageLayoutContainer::paintAnimatedElements(QPainter &painter, int yOffset)
+void MessageLayoutContainer::paintAnimatedElements(QPainter &painter, int yOffset) const
 {
     for (const std::unique_ptr<MessageLayoutElement> &element : this->elements) {
         element->paintAnimated(painter, yOffset);
@@ -156,7 +169,7 @@ void MessageLayoutContainer::paintAnimatedElements(QPainter &painter, int yOffse
 }
 
 void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
-                                            Selection &selection)
+                                            Selection &selection) const
 {
 }
 }  // namespace layouts
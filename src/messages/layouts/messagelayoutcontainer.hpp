@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <QPoint>
+#include <QString>
 
 class QPainter;
 
@@ -50,6 +51,10 @@ public:
     bool enableCompactEmotes;
     int width;
 
+    // taken from the settings on the gui thread, the elements may be laid out on any thread
+    int emoteQuality = 0;
+    QString timestampFormat;
+
     int getHeight() const;
 
     // methods
@@ -60,12 +65,16 @@ public:
     bool atStartOfLine();
     bool fitsInLine(int width);
     void finish();
-    MessageLayoutElement *getElementAt(QPoint point);
+    MessageLayoutElement *getElementAt(QPoint point) const;
+    // keeps an object the layout elements point to alive until the elements are cleared, e.g.
+    // the formatted text of a timestamp
+    void keepAlive(std::shared_ptr<const void> object);
+    size_t getApproximateSize() const;
 
     // painting
-    void paintElements(QPainter &painter);
-    void paintAnimatedElements(QPainter &painter, int yOffset);
-    void paintSelection(QPainter &painter, int messageIndex, Selection &selection);
+    void paintElements(QPainter &painter) const;
+    void paintAnimatedElements(QPainter &painter, int yOffset) const;
+    void paintSelection(QPainter &painter, int messageIndex, Selection &selection) const;
 
 private:
     // helpers
@@ -78,6 +87,8 @@ private:
     size_t lineStart = 0;
     int lineHeight = 0;
     int spaceWidth = 4;
+    // destroyed after the elements that point to them
+    std::vector<std::shared_ptr<const void>> keptAlive;
     std::vector<std::unique_ptr<MessageLayoutElement>> elements;
 };
 }  // namespace layouts
@@ -92,10 +92,13 @@ int ImageLayoutElement::getMouseOverIndex(const QPoint &abs)
 // TEXT
 //
 
-TextLayoutElement::TextLayoutElement(MessageElement &_creator, QString &_text, QSize _size,
-                                     QColor _color, FontStyle _style, float _scale)
+TextLayoutElement::TextLayoutElement(MessageElement &_creator, const QString &_text, int _start,
+                                     int _length, QSize _size, const MessageColor &_color,
+                                     FontStyle _style, float _scale)
     : MessageLayoutElement(_creator, _size)
     , text(_text)
+    , start(_start)
+    , length(_length)
     , color(_color)
     , style(_style)
     , scale(_scale)
@@ -108,17 +111,38 @@ void TextLayoutElement::addCopyTextToString(QString &str, int from, int to) cons
 
 int TextLayoutElement::getSelectionIndexCount()
 {
-    return this->text.length() + (this->trailingSpace ? 1 : 0);
+    return this->length + (this->trailingSpace ? 1 : 0);
 }
 
 void TextLayoutElement::paint(QPainter &painter)
 {
-    painter.setPen(this->color);
+    singletons::FontManager &fontManager = singletons::FontManager::getInstance();
 
-    painter.setFont(singletons::FontManager::getInstance().getFont(this->style, this->scale));
+    int generation = fontManager.getGeneration();
+    QFont &font = fontManager.getFont(this->style, this->scale);
 
-    painter.drawText(QRectF(this->getRect().x(), this->getRect().y(), 10000, 10000), this->text,
-                     QTextOption(Qt::AlignLeft | Qt::AlignTop));
+    if (this->staticTextGeneration != generation) {
+        // points into this->text, which lives as long as the static text
+        this->staticText.setText(
+            QString::fromRawData(this->text.constData() + this->start, this->length));
+        this->staticText.setTextFormat(Qt::PlainText);
+        this->staticText.prepare(QTransform(), font);
+        this->staticTextGeneration = generation;
+    }
+
+    // consecutive words mostly share the font and the color, the painter state is only changed
+    // when they differ so runs of them are drawn back to back
+    if (painter.font() != font) {
+        painter.setFont(font);
+    }
+
+    const QColor &color = this->color.getColor(singletons::ThemeManager::getInstance());
+
+    if (painter.pen().color() != color) {
+        painter.setPen(color);
+    }
+
+    painter.drawStaticText(this->getRect().topLeft(), this->staticText);
 }
 
 void TextLayoutElement::paintAnimated(QPainter &, int)
@@ -2,6 +2,7 @@
 
 #include <QPoint>
 #include <QRect>
+#include <QStaticText>
 #include <QString>
 
 #include <boost/noncopyable.hpp>
@@ -67,8 +68,11 @@ private:
 class TextLayoutElement : public MessageLayoutElement
 {
 public:
-    TextLayoutElement(MessageElement &creator, QString &text, QSize size, QColor color,
-                      FontStyle style, float scale);
+    // the color is resolved when painting, the element may be created on a layout thread.
+    // the element shows `length` characters of `text` starting at `start`, it shares the string
+    // instead of copying that part of it.
+    TextLayoutElement(MessageElement &creator, const QString &text, int start, int length,
+                      QSize size, const MessageColor &color, FontStyle style, float scale);
 
 protected:
     virtual void addCopyTextToString(QString &str, int from = 0, int to = INT_MAX) const override;
@@ -79,9 +83,16 @@ protected:
 
 private:
     QString text;
-    QColor color;
+    int start;
+    int length;
+    MessageColor color;
     FontStyle style;
     float scale;
+
+    // shaped on the gui thread the first time the element is painted, and again after the font
+    // changed
+    QStaticText staticText;
+    int staticTextGeneration = -1;
 };
 }  // namespace layouts
 }  // namespace messages
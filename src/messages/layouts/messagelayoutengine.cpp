@@ -0,0 +1,78 @@
+#include "messages/layouts/messagelayoutengine.hpp"
+#include "asyncexec.hpp"
+
+namespace chatterino {
+namespace messages {
+namespace layouts {
+
+MessageLayoutEngine::MessageLayoutEngine()
+{
+}
+
+MessageLayoutEngine::~MessageLayoutEngine()
+{
+    this->threadPool.clear();
+    this->threadPool.waitForDone();
+}
+
+MessageLayoutEngine &MessageLayoutEngine::getInstance()
+{
+    static MessageLayoutEngine instance;
+
+    return instance;
+}
+
+void MessageLayoutEngine::push(Request request)
+{
+    auto job = std::make_shared<Job>();
+    job->request = std::move(request);
+
+    this->threadPool.start(new LambdaRunnable([this, job] {
+        // the layout was resized again or the fonts changed while the job was queued
+        if (job->request.latestId->load() != job->request.id) {
+            return;
+        }
+
+        job->container =
+            MessageLayout::createContainer(*job->request.message, job->request.parameters);
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->finishedJobs.emplace_back(new Job(std::move(*job)));
+
+        if (!this->deliveryQueued) {
+            this->deliveryQueued = true;
+
+            postToThread([this] {
+                this->deliver();  //
+            });
+        }
+    }));
+}
+
+void MessageLayoutEngine::deliver()
+{
+    std::vector<std::unique_ptr<Job>> jobs;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->deliveryQueued = false;
+        jobs.swap(this->finishedJobs);
+    }
+
+    for (const auto &job : jobs) {
+        auto layout = job->request.layout.lock();
+
+        if (layout != nullptr) {
+            layout->setContainer(job->request.id, job->request.parameters,
+                                 std::move(job->container));
+        }
+    }
+
+    this->layoutsFinished.invoke();
+}
+
+}  // namespace layouts
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "messages/layouts/messagelayout.hpp"
+
+#include <QThreadPool>
+#include <pajlada/signals/signal.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+namespace layouts {
+
+//
+// Lays out messages on a pool of worker threads
+//
+// - push() is only called on the gui thread, by MessageLayout::layout()
+// - the finished containers are handed to their MessageLayout on the gui thread, in batches,
+//   then layoutsFinished is invoked so the views can lay out and repaint with them
+// - requests that were replaced by a newer one of the same MessageLayout before a worker got to
+//   them are skipped
+//
+class MessageLayoutEngine
+{
+    MessageLayoutEngine();
+
+public:
+    ~MessageLayoutEngine();
+
+    MessageLayoutEngine(const MessageLayoutEngine &) = delete;
+    MessageLayoutEngine &operator=(const MessageLayoutEngine &) = delete;
+
+    static MessageLayoutEngine &getInstance();
+
+    struct Request {
+        std::weak_ptr<MessageLayout> layout;
+        MessagePtr message;
+        MessageLayout::Parameters parameters;
+        int id = 0;
+
+        // the id of the newest request of the layout
+        std::shared_ptr<const std::atomic<int>> latestId;
+    };
+
+    void push(Request request);
+
+    pajlada::Signals::NoArgSignal layoutsFinished;
+
+private:
+    struct Job {
+        Request request;
+        std::shared_ptr<const MessageLayoutContainer> container;
+    };
+
+    void deliver();
+
+    QThreadPool threadPool;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Job>> finishedJobs;
+    bool deliveryQueued = false;
+};
+
+}  // namespace layouts
+}  // namespace messages
+}  // namespace chatterino
@@ -4,6 +4,9 @@
 
 #include "messages/limitedqueuesnapshot.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -22,67 +25,109 @@ namespace messages {
 //   trying to add messages to the start when it's full will not add them
 // - you are able to get a "Snapshot" which captures the state of this object
 // - adding items to this class does not change the "items" of the snapshot
+// - every chunk has exactly `chunkSize` slots so items can be looked up without walking the
+//   chunks, items are stored from `firstChunkOffset` in the first chunk up to `lastChunkEnd` in
+//   the last chunk
+// - the chunk vector has spare slots after the last chunk. New chunks go into the next spare
+//   slot and drained chunks are skipped by moving `firstChunk`, so the vector is only copied once
+//   the spare slots ran out. Drained chunks stay in their slot until then, at most half as many
+//   as there are live chunks.
+//
+// Threading:
+// - there is one writer at a time (pushBack, pushFront, replaceItem, setLimit, clear), writers are
+//   serialized by `writeMutex`
+// - getSnapshot never locks, it reads the last published `State`
+// - a published state is never modified, the writer only writes to chunk slots and item slots
+//   that are not part of any published state and copies chunks before replacing items in them
+// - replaced states are retired and reused once no reader can still be looking at them
+//   (epoch based reclamation, see `ReadGuard` and `tryReclaim`)
 //
 
 template <typename T>
 class LimitedQueue
 {
 protected:
-    typedef std::shared_ptr<std::vector<T>> Chunk;
-    typedef std::shared_ptr<std::vector<Chunk>> ChunkVector;
+    typedef typename LimitedQueueSnapshot<T>::Chunk Chunk;
+    typedef typename LimitedQueueSnapshot<T>::ChunkVector ChunkVector;
+
+    static constexpr size_t chunkSize = LimitedQueueSnapshot<T>::chunkSize;
 
 public:
     LimitedQueue(int _limit = 1000)
         : limit(_limit)
     {
+        this->readers[0].store(0);
+        this->readers[1].store(0);
+
         this->clear();
     }
 
+    ~LimitedQueue()
+    {
+        delete this->published.load();
+
+        for (auto &retired : this->retiredStates) {
+            delete retired.first;
+        }
+
+        for (State *state : this->freeStates) {
+            delete state;
+        }
+    }
+
+    LimitedQueue(const LimitedQueue &) = delete;
+    LimitedQueue &operator=(const LimitedQueue &) = delete;
+
     void clear()
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
+        std::lock_guard<std::mutex> lock(this->writeMutex);
+
+        this->chunks = std::make_shared<std::vector<Chunk>>(spareChunkSlots);
+        this->firstChunk = 0;
+        this->endChunk = 0;
+        this->addChunk();
 
-        this->chunks = std::make_shared<std::vector<std::shared_ptr<std::vector<T>>>>();
-        Chunk chunk = std::make_shared<std::vector<T>>();
-        chunk->resize(this->chunkSize);
-        this->chunks->push_back(chunk);
         this->firstChunkOffset = 0;
         this->lastChunkEnd = 0;
+        this->length = 0;
+
+        this->publish();
     }
 
     // return true if an item was deleted
     // deleted will be set if the item was deleted
     bool pushBack(const T &item, T &deleted)
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
+        std::lock_guard<std::mutex> lock(this->writeMutex);
 
-        Chunk lastChunk = this->chunks->back();
+        this->appendItem(item);
 
-        // still space in the last chunk
-        if (lastChunk->size() <= this->lastChunkEnd) {
-            // create new chunk vector
-            ChunkVector newVector =
-                std::make_shared<std::vector<std::shared_ptr<std::vector<T>>>>();
+        bool wasDeleted = this->deleteFirstItem(deleted);
 
-            // copy chunks
-            for (Chunk &chunk : *this->chunks) {
-                newVector->push_back(chunk);
-            }
+        this->publish();
 
-            // push back new chunk
-            Chunk newChunk = std::make_shared<std::vector<T>>();
-            newChunk->resize(this->chunkSize);
-            newVector->push_back(newChunk);
+        return wasDeleted;
+    }
 
-            // replace current chunk vector
-            this->chunks = newVector;
-            this->lastChunkEnd = 0;
-            lastChunk = this->chunks->back();
+    // appends all items and publishes once, returns the items that were deleted from the start
+    std::vector<T> pushBack(const std::vector<T> &items)
+    {
+        std::vector<T> deletedItems;
+
+        std::lock_guard<std::mutex> lock(this->writeMutex);
+
+        for (const T &item : items) {
+            this->appendItem(item);
+
+            T deleted;
+            if (this->deleteFirstItem(deleted)) {
+                deletedItems.push_back(deleted);
+            }
         }
 
-        lastChunk->at(this->lastChunkEnd++) = item;
+        this->publish();
 
-        return this->deleteFirstItem(deleted);
+        return deletedItems;
     }
 
     // returns a vector with all the accepted items
@@ -90,76 +135,65 @@ public:
     {
         std::vector<T> acceptedItems;
 
-        if (this->space() > 0) {
-            std::lock_guard<std::mutex> lock(this->mutex);
+        std::lock_guard<std::mutex> lock(this->writeMutex);
 
-            // create new vector to clone chunks into
-            ChunkVector newChunks =
-                std::make_shared<std::vector<std::shared_ptr<std::vector<T>>>>();
+        size_t offset = std::min(this->space(), items.size());
 
-            newChunks->resize(this->chunks->size());
+        if (offset == 0) {
+            return acceptedItems;
+        }
 
-            // copy chunks except for first one
-            for (size_t i = 1; i < this->chunks->size(); i++) {
-                newChunks->at(i) = this->chunks->at(i);
-            }
+        // prepend as many empty chunks as needed to fit the new items. The slots before the
+        // first chunk may still be read by snapshots, so the vector is copied.
+        size_t newChunkCount = 0;
+        if (offset > this->firstChunkOffset) {
+            newChunkCount = (offset - this->firstChunkOffset + chunkSize - 1) / chunkSize;
+        }
 
-            // create new chunk for the first one
-            size_t offset = std::min(this->space(), items.size());
-            Chunk newFirstChunk = std::make_shared<std::vector<T>>();
-            newFirstChunk->resize(this->chunks->front()->size() + offset);
+        this->reallocate(newChunkCount);
 
-            for (size_t i = 0; i < offset; i++) {
-                newFirstChunk->at(i) = items[items.size() - offset + i];
-                acceptedItems.push_back(items[items.size() - offset + i]);
-            }
+        for (size_t i = 0; i < newChunkCount; i++) {
+            (*this->chunks)[i] = std::make_shared<std::vector<T>>(chunkSize);
+        }
 
-            for (size_t i = 0; i < this->chunks->at(0)->size(); i++) {
-                newFirstChunk->at(i + offset) = this->chunks->at(0)->at(i);
-            }
+        // the old first chunk is shared with snapshots so it needs to be copied before writing
+        Chunk &oldFirstChunk = (*this->chunks)[newChunkCount];
+        if (this->firstChunkOffset > 0) {
+            oldFirstChunk = std::make_shared<std::vector<T>>(*oldFirstChunk);
+        }
 
-            newChunks->at(0) = newFirstChunk;
+        this->firstChunk = 0;
+        this->firstChunkOffset = newChunkCount * chunkSize + this->firstChunkOffset - offset;
 
-            this->chunks = newChunks;
-            qDebug() << acceptedItems.size();
-            qDebug() << this->chunks->at(0)->size();
+        acceptedItems.reserve(offset);
 
-            if (this->chunks->size() == 1) {
-                this->lastChunkEnd += offset;
-            }
+        for (size_t i = 0; i < offset; i++) {
+            size_t position = this->firstChunkOffset + i;
+            const T &item = items[items.size() - offset + i];
+
+            (*this->chunks)[position / chunkSize]->at(position % chunkSize) = item;
+            acceptedItems.push_back(item);
         }
 
+        this->length += offset;
+        this->dropEmptyChunks();
+
+        this->publish();
+
         return acceptedItems;
     }
 
     // replace an single item, return index if successful, -1 if unsuccessful
     int replaceItem(const T &item, const T &replacement)
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
-
-        int x = 0;
-
-        for (size_t i = 0; i < this->chunks->size(); i++) {
-            Chunk &chunk = this->chunks->at(i);
-
-            size_t start = i == 0 ? this->firstChunkOffset : 0;
-            size_t end = i == chunk->size() - 1 ? this->lastChunkEnd : chunk->size();
+        std::lock_guard<std::mutex> lock(this->writeMutex);
 
-            for (size_t j = start; j < end; j++) {
-                if (chunk->at(j) == item) {
-                    Chunk newChunk = std::make_shared<std::vector<T>>();
-                    newChunk->resize(chunk->size());
+        for (size_t i = 0; i < this->length; i++) {
+            if (this->at(i) == item) {
+                this->setItem(i, replacement);
+                this->publish();
 
-                    for (size_t k = 0; k < chunk->size(); k++) {
-                        newChunk->at(k) = chunk->at(k);
-                    }
-
-                    newChunk->at(j) = replacement;
-                    this->chunks->at(i) = newChunk;
-
-                    return x;
-                }
-                x++;
+                return (int)i;
             }
         }
 
@@ -169,103 +203,279 @@ public:
     // replace an item at index, return true if worked
     bool replaceItem(size_t index, const T &replacement)
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
+        std::lock_guard<std::mutex> lock(this->writeMutex);
 
-        size_t x = 0;
+        if (index >= this->length) {
+            return false;
+        }
 
-        for (size_t i = 0; i < this->chunks->size(); i++) {
-            Chunk &chunk = this->chunks->at(i);
+        this->setItem(index, replacement);
+        this->publish();
 
-            size_t start = i == 0 ? this->firstChunkOffset : 0;
-            size_t end = i == chunk->size() - 1 ? this->lastChunkEnd : chunk->size();
+        return true;
+    }
 
-            for (size_t j = start; j < end; j++) {
-                if (x == index) {
-                    Chunk newChunk = std::make_shared<std::vector<T>>();
-                    newChunk->resize(chunk->size());
+    // changes the maximum amount of items, returns the items that had to be removed from the start
+    std::vector<T> setLimit(size_t newLimit)
+    {
+        std::vector<T> removedItems;
 
-                    for (size_t k = 0; k < chunk->size(); k++) {
-                        newChunk->at(k) = chunk->at(k);
-                    }
+        std::lock_guard<std::mutex> lock(this->writeMutex);
 
-                    newChunk->at(j) = replacement;
-                    this->chunks->at(i) = newChunk;
+        this->limit = newLimit;
 
-                    return true;
-                }
-                x++;
-            }
+        if (this->length <= this->limit) {
+            return removedItems;
+        }
+
+        size_t count = this->length - this->limit;
+        removedItems.reserve(count);
+
+        for (size_t i = 0; i < count; i++) {
+            removedItems.push_back(this->at(i));
         }
-        return false;
+
+        this->firstChunkOffset += count;
+        this->length -= count;
+
+        this->dropEmptyChunks();
+
+        this->publish();
+
+        return removedItems;
+    }
+
+    size_t getLimit()
+    {
+        std::lock_guard<std::mutex> lock(this->writeMutex);
+
+        return this->limit;
     }
 
     //    void insertAfter(const std::vector<T> &items, const T &index)
 
-    messages::LimitedQueueSnapshot<T> getSnapshot()
+    // lock-free, may be called from any thread
+    messages::LimitedQueueSnapshot<T> getSnapshot() const
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
+        ReadGuard guard(*this);
 
-        return LimitedQueueSnapshot<T>(this->chunks, this->limit - this->space(),
-                                       this->firstChunkOffset, this->lastChunkEnd);
+        const State *state = this->published.load();
+
+        return LimitedQueueSnapshot<T>(state->chunks, state->length, state->firstPosition);
     }
 
 private:
+    // spare chunk slots of an empty queue
+    static constexpr size_t spareChunkSlots = 4;
+
+    // immutable while published
+    struct State {
+        ChunkVector chunks;
+        size_t length;
+        // position of the first item, counted over all chunk slots
+        size_t firstPosition;
+    };
+
+    // Marks the calling thread as reading `published` during `epoch`.
+    // The writer only advances the epoch once nobody is reading in the epoch before the current
+    // one, so a state retired in epoch `e` can be reused once the epoch reached `e + 2`.
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(const LimitedQueue &_queue)
+            : queue(_queue)
+        {
+            while (true) {
+                this->epoch = this->queue.epoch.load();
+                this->queue.readers[this->epoch & 1].fetch_add(1);
+
+                if (this->queue.epoch.load() == this->epoch) {
+                    break;
+                }
+
+                this->queue.readers[this->epoch & 1].fetch_sub(1);
+            }
+        }
+
+        ~ReadGuard()
+        {
+            this->queue.readers[this->epoch & 1].fetch_sub(1);
+        }
+
+    private:
+        const LimitedQueue &queue;
+        uint64_t epoch;
+    };
+
+    void publish()
+    {
+        State *state;
+
+        // states that no reader can see anymore are reused, so publishing doesn't allocate
+        if (this->freeStates.empty()) {
+            state = new State;
+        } else {
+            state = this->freeStates.back();
+            this->freeStates.pop_back();
+        }
+
+        state->chunks = this->chunks;
+        state->length = this->length;
+        state->firstPosition = this->firstChunk * chunkSize + this->firstChunkOffset;
+
+        State *old = this->published.exchange(state);
+
+        if (old != nullptr) {
+            this->retiredStates.emplace_back(old, this->epoch.load());
+        }
+
+        this->tryReclaim();
+    }
+
+    void tryReclaim()
+    {
+        uint64_t current = this->epoch.load();
+
+        // readers can only be in the current or previous epoch, advance if the previous one
+        // has drained
+        if (this->readers[(current + 1) & 1].load() == 0) {
+            this->epoch.store(++current);
+        }
+
+        auto it = this->retiredStates.begin();
+        for (; it != this->retiredStates.end() && it->second + 2 <= current; it++) {
+            // don't keep the chunks alive while the state is unused
+            it->first->chunks.reset();
+            this->freeStates.push_back(it->first);
+        }
+
+        this->retiredStates.erase(this->retiredStates.begin(), it);
+    }
+
     size_t space()
     {
-        size_t totalSize = 0;
-        for (Chunk &chunk : *this->chunks) {
-            totalSize += chunk->size();
+        return this->limit - this->length;
+    }
+
+    T &at(size_t index)
+    {
+        size_t position = this->firstChunk * chunkSize + this->firstChunkOffset + index;
+
+        return (*this->chunks)[position / chunkSize]->at(position % chunkSize);
+    }
+
+    // copies the chunk that contains the index so snapshots keep their items
+    void setItem(size_t index, const T &replacement)
+    {
+        size_t position = this->firstChunk * chunkSize + this->firstChunkOffset + index;
+
+        ChunkVector newVector = std::make_shared<std::vector<Chunk>>(*this->chunks);
+        Chunk &chunk = (*newVector)[position / chunkSize];
+
+        chunk = std::make_shared<std::vector<T>>(*chunk);
+        chunk->at(position % chunkSize) = replacement;
+
+        this->chunks = newVector;
+    }
+
+    // copies the live chunks into a new vector with `frontSlots` empty slots before them and
+    // spare slots after them
+    void reallocate(size_t frontSlots)
+    {
+        size_t liveChunks = this->endChunk - this->firstChunk;
+
+        ChunkVector newVector = std::make_shared<std::vector<Chunk>>(
+            frontSlots + liveChunks + liveChunks / 2 + spareChunkSlots);
+
+        std::copy(this->chunks->begin() + this->firstChunk,
+                  this->chunks->begin() + this->endChunk, newVector->begin() + frontSlots);
+
+        this->chunks = newVector;
+        this->firstChunk = frontSlots;
+        this->endChunk = frontSlots + liveChunks;
+    }
+
+    // the slot after the last chunk isn't part of any published state, so it can be written
+    // while snapshots share the vector
+    void addChunk()
+    {
+        if (this->endChunk == this->chunks->size()) {
+            this->reallocate(0);
         }
 
-        totalSize -= this->chunks->back()->size() - this->lastChunkEnd;
-        if (this->chunks->size() != 1) {
-            totalSize -= this->firstChunkOffset;
+        (*this->chunks)[this->endChunk++] = std::make_shared<std::vector<T>>(chunkSize);
+    }
+
+    void appendItem(const T &item)
+    {
+        // no space left in the last chunk
+        if (this->lastChunkEnd == chunkSize) {
+            this->addChunk();
+            this->lastChunkEnd = 0;
         }
 
-        return this->limit - totalSize;
+        (*this->chunks)[this->endChunk - 1]->at(this->lastChunkEnd++) = item;
+        this->length++;
     }
 
     bool deleteFirstItem(T &deleted)
     {
         // determine if the first chunk should be deleted
-        if (space() > 0) {
+        if (this->length <= this->limit) {
             return false;
         }
 
-        deleted = this->chunks->front()->at(this->firstChunkOffset);
+        deleted = (*this->chunks)[this->firstChunk]->at(this->firstChunkOffset);
 
         this->firstChunkOffset++;
+        this->length--;
 
-        // need to delete the first chunk
-        if (this->firstChunkOffset == this->chunks->front()->size() - 1) {
-            // copy the chunk vector
-            ChunkVector newVector =
-                std::make_shared<std::vector<std::shared_ptr<std::vector<T>>>>();
-
-            // delete first chunk
-            bool first = true;
-            for (Chunk &chunk : *this->chunks) {
-                if (!first) {
-                    newVector->push_back(chunk);
-                }
-                first = false;
-            }
+        this->dropEmptyChunks();
 
-            this->chunks = newVector;
-            this->firstChunkOffset = 0;
-        }
         return true;
     }
 
+    // keeps `firstChunkOffset` inside the first chunk
+    void dropEmptyChunks()
+    {
+        while (this->firstChunkOffset >= chunkSize) {
+            this->firstChunk++;
+            this->firstChunkOffset -= chunkSize;
+
+            // every item was removed, e.g. with a limit of 0
+            if (this->firstChunk == this->endChunk) {
+                this->addChunk();
+                this->firstChunkOffset = 0;
+                this->lastChunkEnd = 0;
+            }
+        }
+    }
+
+    // writer side, guarded by writeMutex
+    std::mutex writeMutex;
     ChunkVector chunks;
-    std::mutex mutex;
+    // the live chunks are in the slots [firstChunk, endChunk)
+    size_t firstChunk;
+    size_t endChunk;
+
+    std::atomic<State *> published{nullptr};
+    std::vector<std::pair<State *, uint64_t>> retiredStates;
+    std::vector<State *> freeStates;
+
+    mutable std::atomic<uint64_t> epoch{0};
+    mutable std::atomic<int> readers[2];
 
     size_t firstChunkOffset;
     size_t lastChunkEnd;
+    size_t length;
     size_t limit;
-
-    const size_t chunkSize = 100;
 };
 
+template <typename T>
+constexpr size_t LimitedQueue<T>::chunkSize;
+
+template <typename T>
+constexpr size_t LimitedQueue<T>::spareChunkSlots;
+
 }  // namespace messages
 }  // namespace chatterino
@@ -1,62 +1,130 @@
 #pragma once
 
 #include <cassert>
+#include <iterator>
 #include <memory>
 #include <vector>
 
 namespace chatterino {
 namespace messages {
 
+//
+// A snapshot of a LimitedQueue
+//
+// - all chunks have exactly `chunkSize` slots, which makes indexing a shift and a mask
+// - the items are stored from position `firstChunkOffset`, counted over all chunk slots, up to
+//   `length` items later. The slots before and after them may be empty.
+//
+
 template <typename T>
 class LimitedQueueSnapshot
 {
 public:
+    // must be a power of two
+    static constexpr size_t chunkSize = 128;
+
+    typedef std::shared_ptr<std::vector<T>> Chunk;
+    typedef std::shared_ptr<std::vector<Chunk>> ChunkVector;
+
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        Iterator(const std::vector<Chunk> *_chunks, size_t _position)
+            : chunks(_chunks)
+            , position(_position)
+        {
+        }
+
+        const T &operator*() const
+        {
+            return (*(*this->chunks)[this->position / chunkSize])[this->position % chunkSize];
+        }
+
+        const T *operator->() const
+        {
+            return &**this;
+        }
+
+        Iterator &operator++()
+        {
+            this->position++;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator copy = *this;
+            this->position++;
+            return copy;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return this->position == other.position;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return this->position != other.position;
+        }
+
+    private:
+        const std::vector<Chunk> *chunks;
+        size_t position;
+    };
+
     LimitedQueueSnapshot()
         : length(0)
+        , firstChunkOffset(0)
     {
     }
 
-    LimitedQueueSnapshot(std::shared_ptr<std::vector<std::shared_ptr<std::vector<T>>>> _chunks,
-                         size_t _length, size_t _firstChunkOffset, size_t _lastChunkEnd)
+    LimitedQueueSnapshot(ChunkVector _chunks, size_t _length, size_t _firstChunkOffset)
         : chunks(_chunks)
         , length(_length)
         , firstChunkOffset(_firstChunkOffset)
-        , lastChunkEnd(_lastChunkEnd)
     {
     }
 
-    std::size_t getLength()
+    std::size_t getLength() const
     {
         return this->length;
     }
 
     T const &operator[](std::size_t index) const
     {
-        index += this->firstChunkOffset;
+        assert(index < this->length && "out of range");
 
-        size_t x = 0;
-
-        for (size_t i = 0; i < this->chunks->size(); i++) {
-            auto &chunk = this->chunks->at(i);
+        index += this->firstChunkOffset;
 
-            if (x <= index && x + chunk->size() > index) {
-                return chunk->at(index - x);
-            }
-            x += chunk->size();
-        }
+        return (*(*this->chunks)[index / chunkSize])[index % chunkSize];
+    }
 
-        assert(false && "out of range");
+    Iterator begin() const
+    {
+        return Iterator(this->chunks.get(), this->firstChunkOffset);
+    }
 
-        return this->chunks->at(0)->at(0);
+    Iterator end() const
+    {
+        return Iterator(this->chunks.get(), this->firstChunkOffset + this->length);
     }
 
 private:
-    std::shared_ptr<std::vector<std::shared_ptr<std::vector<T>>>> chunks;
+    ChunkVector chunks;
 
     size_t length;
     size_t firstChunkOffset;
-    size_t lastChunkEnd;
 };
 
+template <typename T>
+constexpr size_t LimitedQueueSnapshot<T>::chunkSize;
+
 }  // namespace messages
 }  // namespace chatterino
@@ -1,19 +1,21 @@
 #include "messages/message.hpp"
 #include "messageelement.hpp"
-#include "util/irchelpers.hpp"
 
 typedef chatterino::widgets::ScrollbarHighlight SBHighlight;
 
 namespace chatterino {
 namespace messages {
 
-// elements
-void Message::addElement(MessageElement *element)
+Message::~Message()
 {
-    this->elements.push_back(std::unique_ptr<MessageElement>(element));
+    // the arena only frees the memory
+    for (auto it = this->elements.rbegin(); it != this->elements.rend(); it++) {
+        (*it)->~MessageElement();
+    }
 }
 
-const std::vector<std::unique_ptr<MessageElement>> &Message::getElements() const
+// elements
+const std::vector<MessageElement *> &Message::getElements() const
 {
     return this->elements;
 }
@@ -31,7 +33,7 @@ bool Message::hasFlags(MessageFlags _flags) const
 
 void Message::setFlags(MessageFlags _flags)
 {
-    this->flags = flags;
+    this->flags = _flags;
 }
 
 void Message::addFlags(MessageFlags _flags)
@@ -61,6 +63,28 @@ void Message::setId(const QString &_id)
     this->id = _id;
 }
 
+// Irc data
+const QByteArray &Message::getIrcData() const
+{
+    return this->ircData;
+}
+
+void Message::setIrcData(const QByteArray &data)
+{
+    this->ircData = data;
+}
+
+// Sent time
+qint64 Message::getSentTimestamp() const
+{
+    return this->sentTimestamp;
+}
+
+void Message::setSentTimestamp(qint64 timestamp)
+{
+    this->sentTimestamp = timestamp;
+}
+
 // Search
 const QString &Message::getSearchText() const
 {
@@ -98,13 +122,41 @@ SBHighlight Message::getScrollBarHighlight() const
     return SBHighlight();
 }
 
+// Memory
+size_t Message::getApproximateSize() const
+{
+    if (this->approximateSize == 0) {
+        size_t size = sizeof(Message) + this->elements.capacity() * sizeof(void *);
+
+        // the usernames are interned and shared with other messages
+        size += this->id.size() * sizeof(QChar) + this->ircData.size();
+
+        for (const MessageElement *element : this->elements) {
+            size += element->getApproximateSize();
+        }
+
+        // the elements live in the arena, add the bytes of its blocks they don't use
+        size += this->elementArena.getCapacity() - this->elementArena.getUsed();
+
+        this->approximateSize = size;
+    }
+
+    return this->approximateSize;
+}
+
+// Timeouts
+const util::Symbol &Message::getTimeoutUser() const
+{
+    return this->timeoutUser;
+}
+
 // Static
 MessagePtr Message::createSystemMessage(const QString &text)
 {
     MessagePtr message(new Message);
 
-    message->addElement(new TimestampElement(QTime::currentTime()));
-    message->addElement(new TextElement(text, MessageElement::Text, MessageColor::System));
+    message->emplaceElement<TimestampElement>(QTime::currentTime());
+    message->emplaceElement<TextElement>(text, MessageElement::Text, MessageColor::System);
     message->addFlags(Message::System);
 
     return MessagePtr(message);
@@ -135,7 +187,7 @@ MessagePtr Message::createTimeoutMessage(const QString &username, const QString
 
     if (reason.length() > 0) {
         text.append(": \"");
-        text.append(util::ParseTagString(reason));
+        text.append(reason);
         text.append("\"");
     }
     text.append(".");
@@ -146,7 +198,7 @@ MessagePtr Message::createTimeoutMessage(const QString &username, const QString
 
     MessagePtr message = Message::createSystemMessage(text);
     message->addFlags(Message::Timeout);
-    message->timeoutUser = username;
+    message->timeoutUser = util::Symbol(username);
     return message;
 }
 
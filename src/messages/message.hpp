@@ -1,10 +1,13 @@
 #pragma once
 
 #include "messages/messageelement.hpp"
+#include "util/arena.hpp"
+#include "util/symbol.hpp"
 #include "widgets/helper/scrollbarhighlight.hpp"
 
 #include <cinttypes>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include <QTime>
@@ -31,10 +34,27 @@ public:
         Collapsed = (1 << 7),
     };
 
+    Message() = default;
+    ~Message();
+
     // Elements
     // Messages should not be added after the message is done initializing.
-    void addElement(MessageElement *element);
-    const std::vector<std::unique_ptr<MessageElement>> &getElements() const;
+    // The elements are allocated in the arena of the message.
+    template <typename T, typename... Args>
+    T *emplaceElement(Args &&... args)
+    {
+        static_assert(std::is_base_of<MessageElement, T>::value, "T must extend MessageElement");
+
+        if (this->elements.empty()) {
+            this->elements.reserve(16);
+        }
+
+        T *element = this->elementArena.create<T>(std::forward<Args>(args)...);
+        this->elements.push_back(element);
+
+        return element;
+    }
+    const std::vector<MessageElement *> &getElements() const;
 
     // Message flags
     MessageFlags getFlags() const;
@@ -50,20 +70,35 @@ public:
     const QString &getId() const;
     void setId(const QString &id);
 
+    // Irc data
+    // The line the message was parsed from, used to restore the message from the cold storage
+    const QByteArray &getIrcData() const;
+    void setIrcData(const QByteArray &data);
+
+    // Sent time
+    // Milliseconds since epoch at which twitch received the message, 0 if unknown
+    qint64 getSentTimestamp() const;
+    void setSentTimestamp(qint64 timestamp);
+
     // Searching
     const QString &getSearchText() const;
 
     // Scrollbar
     widgets::ScrollbarHighlight getScrollBarHighlight() const;
 
+    // Memory
+    // Rough amount of bytes used by the message and its elements. It is calculated once since
+    // elements can't be added after the message is done initializing.
+    size_t getApproximateSize() const;
+
     // Usernames
-    QString loginName;
-    QString displayName;
-    QString localizedName;
+    // Interned since the same chatters show up in many messages
+    util::Symbol loginName;
+    util::Symbol displayName;
+    util::Symbol localizedName;
 
     // Timeouts
-    const QString &getTimeoutUser(const QString &value) const;
-    void setTimeoutUser();
+    const util::Symbol &getTimeoutUser() const;
 
     // Static
     static MessagePtr createSystemMessage(const QString &text);
@@ -76,13 +111,18 @@ private:
     static QRegularExpression *cheerRegex;
 
     MessageFlags flags = MessageFlags::None;
-    QString timeoutUser;
+    util::Symbol timeoutUser;
     bool collapsedDefault = false;
     QTime parseTime;
     mutable QString searchText;
+    mutable size_t approximateSize = 0;
     QString id = "";
+    QByteArray ircData;
+    qint64 sentTimestamp = 0;
 
-    std::vector<std::unique_ptr<MessageElement>> elements;
+    // owns the memory of the elements, they are destroyed in ~Message
+    util::Arena elementArena;
+    std::vector<MessageElement *> elements;
 };
 
 }  // namespace messages
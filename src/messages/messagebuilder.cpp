@@ -2,6 +2,7 @@
 #include "singletons/emotemanager.hpp"
 #include "singletons/resourcemanager.hpp"
 #include "singletons/thememanager.hpp"
+#include "util/linkdetector.hpp"
 
 #include <QDateTime>
 
@@ -18,11 +19,6 @@ MessagePtr MessageBuilder::getMessage()
     return this->message;
 }
 
-void MessageBuilder::appendElement(MessageElement *element)
-{
-    this->message->addElement(element);
-}
-
 void MessageBuilder::appendTimestamp()
 {
     this->appendTimestamp(QTime::currentTime());
@@ -39,23 +35,20 @@ void MessageBuilder::setHighlight(bool value)
 
 void MessageBuilder::appendTimestamp(const QTime &time)
 {
-    this->appendElement(new TimestampElement(time));
+    this->append<TimestampElement>(time);
 }
 
 QString MessageBuilder::matchLink(const QString &string)
 {
-    static QRegularExpression linkRegex("[[:ascii:]]*\\.[a-zA-Z]+\\/?[[:ascii:]]*");
-    static QRegularExpression httpRegex("\\bhttps?://");
-
-    auto match = linkRegex.match(string);
+    util::LinkMatch match;
 
-    if (!match.hasMatch()) {
+    if (!util::detectLink(string, match)) {
         return QString();
     }
 
-    QString captured = match.captured();
+    QString captured = string.mid(match.start, match.length);
 
-    if (!captured.contains(httpRegex)) {
+    if (!match.hasScheme) {
         captured.insert(0, "http://");
     }
 
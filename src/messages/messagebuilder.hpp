@@ -17,18 +17,14 @@ public:
     MessagePtr getMessage();
 
     void setHighlight(bool value);
-    void appendElement(MessageElement *element);
 
     //    typename std::enable_if<std::is_base_of<MessageElement, T>::value, T>::type
 
+    // the element is created in the arena of the message
     template <class T, class... Args>
     T *append(Args &&... args)
     {
-        static_assert(std::is_base_of<MessageElement, T>::value, "T must extend MessageElement");
-
-        T *element = new T(std::forward<Args>(args)...);
-        this->appendElement(element);
-        return element;
+        return this->message->emplaceElement<T>(std::forward<Args>(args)...);
     }
 
     void appendTimestamp();
@@ -4,6 +4,10 @@
 #include "singletons/settingsmanager.hpp"
 #include "util/benchmark.hpp"
 #include "util/emotemap.hpp"
+#include "util/messagetokenizer.hpp"
+#include "util/wordwidthcache.hpp"
+
+#include <memory>
 
 namespace chatterino {
 namespace messages {
@@ -20,6 +24,12 @@ MessageElement *MessageElement::setLink(const Link &_link)
 }
 
 MessageElement *MessageElement::setTooltip(const QString &_tooltip)
+{
+    this->tooltip = util::Symbol(_tooltip);
+    return this;
+}
+
+MessageElement *MessageElement::setTooltip(const util::Symbol &_tooltip)
 {
     this->tooltip = _tooltip;
     return this;
@@ -33,7 +43,7 @@ MessageElement *MessageElement::setTrailingSpace(bool value)
 
 const QString &MessageElement::getTooltip() const
 {
-    return this->tooltip;
+    return this->tooltip.toString();
 }
 
 const Link &MessageElement::getLink() const
@@ -51,6 +61,12 @@ MessageElement::Flags MessageElement::getFlags() const
     return this->flags;
 }
 
+size_t MessageElement::getApproximateSize() const
+{
+    // the tooltip is interned and shared with other elements
+    return sizeof(MessageElement) + this->link.getValue().size() * sizeof(QChar);
+}
+
 // IMAGE
 ImageElement::ImageElement(Image &_image, MessageElement::Flags flags)
     : MessageElement(flags)
@@ -71,6 +87,11 @@ void ImageElement::update(UpdateFlags _flags)
 {
 }
 
+size_t ImageElement::getApproximateSize() const
+{
+    return MessageElement::getApproximateSize() + sizeof(ImageElement) - sizeof(MessageElement);
+}
+
 // EMOTE
 EmoteElement::EmoteElement(const util::EmoteData &_data, MessageElement::Flags flags)
     : MessageElement(flags)
@@ -88,7 +109,7 @@ void EmoteElement::addToContainer(MessageLayoutContainer &container, MessageElem
         return;
     }
 
-    int quality = singletons::SettingManager::getInstance().preferredEmoteQuality;
+    int quality = container.emoteQuality;
 
     Image *_image;
     if (quality == 3 && this->data.image3x != nullptr) {
@@ -109,6 +130,11 @@ void EmoteElement::update(UpdateFlags _flags)
 {
 }
 
+size_t EmoteElement::getApproximateSize() const
+{
+    return MessageElement::getApproximateSize() + sizeof(EmoteElement) - sizeof(MessageElement);
+}
+
 // TEXT
 TextElement::TextElement(const QString &text, MessageElement::Flags flags,
                          const MessageColor &_color, FontStyle _style)
@@ -116,32 +142,53 @@ TextElement::TextElement(const QString &text, MessageElement::Flags flags,
     , color(_color)
     , style(_style)
 {
-    for (QString word : text.split(' ')) {
-        this->words.push_back({word, -1});
+    util::MessageTokens tokens;
+    util::tokenizeMessage(text, tokens);
+
+    this->words.reserve(tokens.size());
+
+    for (const util::MessageToken &token : tokens) {
+        // mid returns a shared copy if the token is the whole text
+        this->words.push_back(text.mid(token.start, token.length));
         // fourtf: add logic to store mutliple spaces after message
     }
 }
 
+TextElement::TextElement(Words _words, MessageElement::Flags flags, const MessageColor &_color,
+                         FontStyle _style)
+    : MessageElement(flags)
+    , color(_color)
+    , style(_style)
+    , words(std::move(_words))
+{
+}
+
 void TextElement::addToContainer(MessageLayoutContainer &container, MessageElement::Flags _flags)
 {
-    QFontMetrics &metrics =
-        singletons::FontManager::getInstance().getFontMetrics(this->style, container.scale);
-    singletons::ThemeManager &themeManager = singletons::ThemeManager::ThemeManager::getInstance();
+    // may run on a layout thread
+    int fontGeneration;
+    const singletons::FontManager::FontData &font =
+        singletons::FontManager::getInstance().getThreadFontData(this->style, container.scale,
+                                                                 fontGeneration);
+
+    for (const QString &word : this->words) {
+        // ascii words are summed up from the advance table, only the rest needs to be shaped
+        int wordWidth;
+
+        if (!font.getAsciiWidth(word, wordWidth)) {
+            wordWidth = util::WordWidthCache::getWidth(word, this->style, container.scale,
+                                                       fontGeneration, font.metrics);
+        }
 
-    for (Word &word : this->words) {
-        auto getTextLayoutElement = [&](QString text, int width) {
-            return new TextLayoutElement(*this, text, QSize(width, metrics.height()),
-                                         this->color.getColor(themeManager), this->style,
-                                         container.scale);
+        auto getTextLayoutElement = [&] {
+            return new TextLayoutElement(*this, word, 0, word.length(),
+                                         QSize(wordWidth, font.metrics.height()), this->color,
+                                         this->style, container.scale);
         };
 
-        if (word.width == -1) {
-            word.width = metrics.width(word.text);
-        }
-
         // see if the text fits in the current line
-        if (container.fitsInLine(word.width)) {
-            container.addElementNoLineBreak(getTextLayoutElement(word.text, word.width));
+        if (container.fitsInLine(wordWidth)) {
+            container.addElementNoLineBreak(getTextLayoutElement());
             continue;
         }
 
@@ -149,46 +196,121 @@ void TextElement::addToContainer(MessageLayoutContainer &container, MessageEleme
         if (!container.atStartOfLine()) {
             container.breakLine();
 
-            if (container.fitsInLine(word.width)) {
-                container.addElementNoLineBreak(getTextLayoutElement(word.text, word.width));
+            if (container.fitsInLine(wordWidth)) {
+                container.addElementNoLineBreak(getTextLayoutElement());
                 continue;
             }
         }
 
         // we done goofed, we need to wrap the text
-        QString text = word.text;
-        int textLength = text.length();
-        int wordStart = 0;
-        int width = metrics.width(text[0]);
-        int lastWidth = 0;
-
-        for (int i = 1; i < textLength; i++) {
-            int chatWidth = metrics.width(text[i]);
-
-            if (!container.fitsInLine(width + chatWidth)) {
-                container.addElementNoLineBreak(
-                    getTextLayoutElement(text.mid(wordStart, i - wordStart), width - lastWidth));
-                container.breakLine();
-
-                i += 2;
-                wordStart = i;
-                lastWidth = width;
-                width += chatWidth;
-                continue;
+        this->wrapWord(container, word, font);
+    }
+}
+
+void TextElement::wrapWord(MessageLayoutContainer &container, const QString &word,
+                           const singletons::FontManager::FontData &font)
+{
+    int length = word.length();
+
+    // true if a break at `index` would split a surrogate pair
+    auto isInsidePair = [&](int index) {
+        return index > 0 && index < length && word[index].isLowSurrogate() &&
+               word[index - 1].isHighSurrogate();
+    };
+
+    // advances of all prefixes of the word in 1/64 pixels, computed once so every line break is
+    // a binary search. A surrogate pair is measured as one character.
+    std::vector<int> prefixAdvances(length + 1);
+    prefixAdvances[0] = 0;
+
+    for (int i = 0; i < length;) {
+        ushort unicode = word[i].unicode();
+        int units = isInsidePair(i + 1) ? 2 : 1;
+        int advance;
+
+        if (unicode < 128) {
+            advance = font.asciiAdvances[unicode];
+        } else {
+            advance = font.metrics.width(QString::fromRawData(word.constData() + i, units)) * 64;
+        }
+
+        if (units == 2) {
+            prefixAdvances[i + 1] = prefixAdvances[i];
+        }
+
+        prefixAdvances[i + units] = prefixAdvances[i] + advance;
+        i += units;
+    }
+
+    auto toPixels = [](int advance) {
+        return (advance + 32) / 64;  //
+    };
+
+    int lineStart = 0;
+
+    while (lineStart < length) {
+        int startX = toPixels(prefixAdvances[lineStart]);
+
+        // the longest part of the rest of the word that fits in the line
+        int end = lineStart;
+        int low = lineStart + 1;
+        int high = length;
+
+        while (low <= high) {
+            int middle = low + (high - low) / 2;
+
+            if (container.fitsInLine(toPixels(prefixAdvances[middle]) - startX)) {
+                end = middle;
+                low = middle + 1;
+            } else {
+                high = middle - 1;
             }
         }
 
-        container.addElement(getTextLayoutElement(text.mid(wordStart), word.width - lastWidth));
+        if (isInsidePair(end)) {
+            end--;
+        }
+
+        // at least one character per line, even if it doesn't fit
+        if (end == lineStart) {
+            end = isInsidePair(lineStart + 1) ? lineStart + 2 : lineStart + 1;
+        }
+
+        auto element = new TextLayoutElement(
+            *this, word, lineStart, end - lineStart,
+            QSize(toPixels(prefixAdvances[end]) - startX, font.metrics.height()), this->color,
+            this->style, container.scale);
+
+        if (end == length) {
+            container.addElement(element);
+        } else {
+            container.addElementNoLineBreak(element);
+            container.breakLine();
+        }
+
+        lineStart = end;
     }
 }
 
 void TextElement::update(UpdateFlags _flags)
 {
-    if (_flags & UpdateFlags::Update_Text) {
-        for (Word &word : this->words) {
-            word.width = -1;
-        }
+}
+
+size_t TextElement::getApproximateSize() const
+{
+    size_t size = MessageElement::getApproximateSize() + sizeof(TextElement) -
+                  sizeof(MessageElement);
+
+    // the inline words are part of sizeof(TextElement), only a spilled buffer is extra
+    if (this->words.capacity() > inlineWords) {
+        size += this->words.capacity() * sizeof(QString);
+    }
+
+    for (const QString &word : this->words) {
+        size += word.size() * sizeof(QChar);
     }
+
+    return size;
 }
 
 // TIMESTAMP
@@ -200,38 +322,55 @@ TimestampElement::TimestampElement()
 TimestampElement::TimestampElement(QTime _time)
     : MessageElement(MessageElement::Timestamp)
     , time(_time)
-    , element(formatTime(_time))
 {
-    assert(this->element != nullptr);
 }
 
 TimestampElement::~TimestampElement()
 {
-    delete this->element;
 }
 
 void TimestampElement::addToContainer(MessageLayoutContainer &container,
                                       MessageElement::Flags _flags)
 {
-    if (singletons::SettingManager::getInstance().timestampFormat != this->format) {
-        this->format = singletons::SettingManager::getInstance().timestampFormat;
-        delete this->element;
-        this->element = TimestampElement::formatTime(this->time);
+    std::shared_ptr<const Formatted> current = std::atomic_load(&this->formatted);
+
+    if (current == nullptr || current->format != container.timestampFormat) {
+        auto newFormatted = std::make_shared<Formatted>();
+        newFormatted->format = container.timestampFormat;
+        newFormatted->element.reset(
+            TimestampElement::formatTime(this->time, container.timestampFormat));
+
+        current = newFormatted;
+        std::atomic_store(&this->formatted, current);
     }
 
-    this->element->addToContainer(container, _flags);
+    container.keepAlive(current);
+    current->element->addToContainer(container, _flags);
 }
 
 void TimestampElement::update(UpdateFlags _flags)
 {
-    this->element->update(_flags);
 }
 
-TextElement *TimestampElement::formatTime(const QTime &time)
+size_t TimestampElement::getApproximateSize() const
 {
-    QString format = time.toString(singletons::SettingManager::getInstance().timestampFormat);
+    size_t size =
+        MessageElement::getApproximateSize() + sizeof(TimestampElement) - sizeof(MessageElement);
+
+    std::shared_ptr<const Formatted> current = std::atomic_load(&this->formatted);
+
+    if (current != nullptr) {
+        size += sizeof(Formatted) + current->format.size() * sizeof(QChar) +
+                current->element->getApproximateSize();
+    }
+
+    return size;
+}
 
-    return new TextElement(format, Flags::Timestamp, MessageColor::System, FontStyle::Medium);
+TextElement *TimestampElement::formatTime(const QTime &time, const QString &format)
+{
+    return new TextElement(time.toString(format), Flags::Timestamp, MessageColor::System,
+                           FontStyle::Medium);
 }
 
 // TWITCH MODERATION
@@ -4,15 +4,21 @@
 #include "messages/link.hpp"
 #include "messages/messagecolor.hpp"
 #include "singletons/fontmanager.hpp"
+#include "util/symbol.hpp"
 
 #include <stdint.h>
 #include <QRect>
 #include <QString>
 #include <QTime>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/noncopyable.hpp>
 #include <util/emotemap.hpp>
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace chatterino {
 class Channel;
 namespace util {
@@ -42,10 +48,13 @@ public:
         BttvEmoteImage = (1 << 6),
         BttvEmoteText = (1 << 7),
         BttvEmote = BttvEmoteImage | BttvEmoteText,
+        ChatterinoEmoteImage = (1 << 8),
+        ChatterinoEmoteText = (1 << 9),
+        ChatterinoEmote = ChatterinoEmoteImage | ChatterinoEmoteText,
         FfzEmoteImage = (1 << 10),
         FfzEmoteText = (1 << 11),
         FfzEmote = FfzEmoteImage | FfzEmoteText,
-        EmoteImages = TwitchEmoteImage | BttvEmoteImage | FfzEmoteImage,
+        EmoteImages = TwitchEmoteImage | BttvEmoteImage | ChatterinoEmoteImage | FfzEmoteImage,
 
         BitsStatic = (1 << 12),
         BitsAnimated = (1 << 13),
@@ -99,7 +108,7 @@ public:
         Collapsed = (1 << 26),
 
         Default = Timestamp | Badges | Username | BitsStatic | FfzEmoteImage | BttvEmoteImage |
-                  TwitchEmoteImage | BitsAmount | Text | AlwaysShow,
+                  ChatterinoEmoteImage | TwitchEmoteImage | BitsAmount | Text | AlwaysShow,
     };
 
     enum UpdateFlags : char {
@@ -115,6 +124,7 @@ public:
 
     MessageElement *setLink(const Link &link);
     MessageElement *setTooltip(const QString &tooltip);
+    MessageElement *setTooltip(const util::Symbol &tooltip);
     MessageElement *setTrailingSpace(bool value);
     const QString &getTooltip() const;
     const Link &getLink() const;
@@ -124,13 +134,16 @@ public:
     virtual void addToContainer(MessageLayoutContainer &container, MessageElement::Flags flags) = 0;
     virtual void update(UpdateFlags flags) = 0;
 
+    // rough amount of bytes used by the element, used by the ScrollbackManager
+    virtual size_t getApproximateSize() const;
+
 protected:
     MessageElement(Flags flags);
     bool trailingSpace = true;
 
 private:
     Link link;
-    QString tooltip;
+    util::Symbol tooltip;
     Flags flags;
 };
 
@@ -145,6 +158,7 @@ public:
     virtual void addToContainer(MessageLayoutContainer &container,
                                 MessageElement::Flags flags) override;
     virtual void update(UpdateFlags flags) override;
+    virtual size_t getApproximateSize() const override;
 };
 
 // contains emote data and will pick the emote based on :
@@ -160,36 +174,57 @@ public:
     virtual void addToContainer(MessageLayoutContainer &container,
                                 MessageElement::Flags flags) override;
     virtual void update(UpdateFlags flags) override;
+    virtual size_t getApproximateSize() const override;
 };
 
 // contains a text, it will split it into words
 class TextElement : public MessageElement
 {
+public:
+    // the builder creates one element per word, so most of them don't need a heap allocation
+    static constexpr size_t inlineWords = 2;
+    typedef boost::container::small_vector<QString, inlineWords> Words;
+
+private:
     MessageColor color;
     FontStyle style;
-
-    struct Word {
-        QString text;
-        int width = -1;
-    };
-    std::vector<Word> words;
+    Words words;
 
 public:
+    // splits the text into words
     TextElement(const QString &text, MessageElement::Flags flags,
                 const MessageColor &color = MessageColor::Text,
                 FontStyle style = FontStyle::Medium);
 
+    // takes words that were already split by util::tokenizeMessage, none of them contain spaces
+    TextElement(Words words, MessageElement::Flags flags,
+                const MessageColor &color = MessageColor::Text,
+                FontStyle style = FontStyle::Medium);
+
     virtual void addToContainer(MessageLayoutContainer &container,
                                 MessageElement::Flags flags) override;
     virtual void update(UpdateFlags flags);
+    virtual size_t getApproximateSize() const override;
+
+private:
+    // lays out a word that is wider than a line over as many lines as needed
+    void wrapWord(MessageLayoutContainer &container, const QString &word,
+                  const singletons::FontManager::FontData &font);
 };
 
 // contains a text, formated depending on the preferences
 class TimestampElement : public MessageElement
 {
     QTime time;
-    TextElement *element;
-    QString format;
+
+    struct Formatted {
+        QString format;
+        std::unique_ptr<TextElement> element;
+    };
+
+    // the timestamp in the format it was last laid out with, read and replaced atomically by the
+    // layout threads. The layouts keep the element they point to alive.
+    std::shared_ptr<const Formatted> formatted;
 
 public:
     TimestampElement();
@@ -199,8 +234,9 @@ public:
     virtual void addToContainer(MessageLayoutContainer &container,
                                 MessageElement::Flags flags) override;
     virtual void update(UpdateFlags flags);
+    virtual size_t getApproximateSize() const override;
 
-    TextElement *formatTime(const QTime &time);
+    static TextElement *formatTime(const QTime &time, const QString &format);
 };
 
 // adds all the custom moderation buttons, adds a variable amount of items depending on settings
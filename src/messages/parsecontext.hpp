@@ -0,0 +1,40 @@
+#pragma once
+
+#include "messages/highlightengine.hpp"
+#include "util/emotetable.hpp"
+
+#include <QColor>
+#include <QString>
+
+#include <memory>
+
+namespace chatterino {
+namespace messages {
+
+//
+// Everything the message builders read besides the message itself
+//
+// - taken from the settings, the theme and the emotes by the SettingManager and replaced as a
+//   whole whenever one of them changes
+// - never modified after it was built, a message is parsed against the same snapshot from start
+//   to end and the builders don't touch any setting, so they can run on any thread
+//
+struct ParseContext {
+    // login name of the current account, empty if anonymous
+    QString currentUsername;
+
+    // one of TwitchMessageBuilder::UsernameDisplayMode
+    int usernameDisplayMode = 3;
+
+    bool enableHighlights = true;
+    std::shared_ptr<const HighlightEngine> highlightEngine;
+
+    // emotes of channels that don't have their own table
+    std::shared_ptr<const util::EmoteTable> globalEmoteTable;
+
+    // usernames without a color
+    QColor systemTextColor;
+};
+
+}  // namespace messages
+}  // namespace chatterino
@@ -1,5 +1,6 @@
 #include "singletons/channelmanager.hpp"
 #include "singletons/ircmanager.hpp"
+#include "singletons/scrollbackmanager.hpp"
 
 using namespace chatterino::twitch;
 
@@ -17,6 +18,13 @@ ChannelManager::ChannelManager()
     , mentionsChannel(new Channel("/mentions"))
     , emptyChannel(new Channel(""))
 {
+    // whispers and mentions keep receiving messages for the whole session and can be shown in
+    // splits like any twitch channel, so they share the budget. The empty channel never holds
+    // messages.
+    auto &scrollbackManager = ScrollbackManager::getInstance();
+
+    scrollbackManager.addChannel(this->whispersChannel);
+    scrollbackManager.addChannel(this->mentionsChannel);
 }
 
 const std::vector<SharedChannel> ChannelManager::getItems()
@@ -50,6 +58,7 @@ SharedChannel ChannelManager::addTwitchChannel(const QString &rawChannelName)
 
     if (it == this->twitchChannels.end()) {
         auto channel = std::make_shared<TwitchChannel>(channelName);
+        ScrollbackManager::getInstance().addChannel(channel);
 
         this->twitchChannels.insert(channelName, std::make_tuple(channel, 1));
 
@@ -87,6 +87,8 @@ EmoteManager::EmoteManager(SettingManager &_settingsManager, WindowManager &_win
         assert(currentUser);
         this->refreshTwitchEmotes(currentUser);
     });
+
+    this->refreshGlobalEmoteTable();
 }
 
 EmoteManager &EmoteManager::getInstance()
@@ -152,6 +154,8 @@ void EmoteManager::reloadBTTVChannelEmotes(const QString &channelName,
         }
 
         this->bttvChannelEmoteCodes[channelName.toStdString()] = codes;
+
+        this->channelEmotesChanged(channelName);
     });
 }
 
@@ -204,6 +208,8 @@ void EmoteManager::reloadFFZChannelEmotes(const QString &channelName,
 
             this->ffzChannelEmoteCodes[channelName.toStdString()] = codes;
         }
+
+        this->channelEmotesChanged(channelName);
     });
 }
 
@@ -222,6 +228,29 @@ util::EmoteMap &EmoteManager::getChatterinoEmotes()
     return _chatterinoEmotes;
 }
 
+std::shared_ptr<const util::EmoteTable> EmoteManager::buildEmoteTable(
+    const util::EmoteMap *bttvChannel, const util::EmoteMap *ffzChannel)
+{
+    // same precedence the builder used to check the maps in
+    return std::make_shared<util::EmoteTable>(util::EmoteTable::Sources{
+        {&this->bttvGlobalEmotes, MessageElement::BttvEmote},
+        {bttvChannel, MessageElement::BttvEmote},
+        {&this->ffzGlobalEmotes, MessageElement::FfzEmote},
+        {ffzChannel, MessageElement::FfzEmote},
+        {&this->_chatterinoEmotes, MessageElement::ChatterinoEmote},
+    });
+}
+
+std::shared_ptr<const util::EmoteTable> EmoteManager::getGlobalEmoteTable() const
+{
+    return std::atomic_load(&this->globalEmoteTable);
+}
+
+void EmoteManager::refreshGlobalEmoteTable()
+{
+    std::atomic_store(&this->globalEmoteTable, this->buildEmoteTable(nullptr, nullptr));
+}
+
 util::EmoteMap &EmoteManager::getBTTVChannelEmoteFromCaches()
 {
     return _bttvChannelEmoteFromCaches;
@@ -250,6 +279,8 @@ void EmoteManager::loadEmojis()
 
     uint unicodeBytes[4];
 
+    util::EmojiTrie::Sequences sequences;
+
     while (!in.atEnd()) {
         // Line example: sunglasses 1f60e
         QString line = in.readLine();
@@ -287,19 +318,20 @@ void EmoteManager::loadEmojis()
         this->emojiShortCodeToEmoji.insert(shortCode, emojiData);
         this->emojiShortCodes.push_back(shortCode.toStdString());
 
-        this->emojiFirstByte[emojiData.value.at(0)].append(emojiData);
-
         QString url = "https://cdnjs.cloudflare.com/ajax/libs/"
                       "emojione/2.2.6/assets/png/" +
                       code + ".png";
 
-        this->emojis.insert(code,
-                            util::EmoteData(new Image(url, 0.35, ":" + shortCode + ":",
-                                                                ":" + shortCode + ":<br/>Emoji")));
+        util::EmoteData emoteData(
+            new Image(url, 0.35, ":" + shortCode + ":", ":" + shortCode + ":<br/>Emoji"));
+
+        this->emojis.insert(code, emoteData);
 
-        // TODO(pajlada): The vectors in emojiFirstByte need to be sorted by
-        // emojiData.code.length()
+        sequences.emplace_back(emojiData.value, int(this->emojiImages.size()));
+        this->emojiImages.push_back(emoteData);
     }
+
+    this->emojiTrie = util::EmojiTrie(std::move(sequences));
 }
 
 void EmoteManager::parseEmojis(std::vector<std::tuple<util::EmoteData, QString>> &parsedWords,
@@ -307,52 +339,16 @@ void EmoteManager::parseEmojis(std::vector<std::tuple<util::EmoteData, QString>>
 {
     int lastParsedEmojiEndIndex = 0;
 
-    for (auto i = 0; i < text.length() - 1; i++) {
-        const QChar character = text.at(i);
-
-        if (character.isLowSurrogate()) {
-            continue;
-        }
-
-        auto it = this->emojiFirstByte.find(character);
-        if (it == this->emojiFirstByte.end()) {
-            // No emoji starts with this character
-            continue;
-        }
-
-        const QVector<EmojiData> possibleEmojis = it.value();
-
-        int remainingCharacters = text.length() - i;
-
-        EmojiData matchedEmoji;
-
-        int matchedEmojiLength = 0;
-
-        for (const EmojiData &emoji : possibleEmojis) {
-            if (remainingCharacters < emoji.value.length()) {
-                // It cannot be this emoji, there's not enough space for it
-                continue;
-            }
-
-            bool match = true;
-
-            for (int j = 1; j < emoji.value.length(); ++j) {
-                if (text.at(i + j) != emoji.value.at(j)) {
-                    match = false;
-
-                    break;
-                }
-            }
-
-            if (match) {
-                matchedEmoji = emoji;
-                matchedEmojiLength = emoji.value.length();
+    const QChar *begin = text.constData();
+    const QChar *end = begin + text.length();
 
-                break;
-            }
-        }
+    for (auto i = 0; i < text.length(); i++) {
+        int emojiIndex;
+        int matchedEmojiLength = this->emojiTrie.findLongest(begin + i, end, emojiIndex);
 
         if (matchedEmojiLength == 0) {
+            // No emoji starts here, no emoji starts with a low surrogate either so pairs don't
+            // need to be skipped
             continue;
         }
 
@@ -368,18 +364,9 @@ void EmoteManager::parseEmojis(std::vector<std::tuple<util::EmoteData, QString>>
                 text.mid(lastParsedEmojiEndIndex, charactersFromLastParsedEmoji)));
         }
 
-        QString url = "https://cdnjs.cloudflare.com/ajax/libs/"
-                      "emojione/2.2.6/assets/png/" +
-                      matchedEmoji.code + ".png";
-
-        // Create or fetch cached emoji image
-        auto emojiImage = this->emojis.getOrAdd(matchedEmoji.code, [this, &url] {
-            return util::EmoteData(
-                new Image(url, 0.35, "?????????", "???????????????"));  //
-        });
-
         // Push the emoji as a word to parsedWords
-        parsedWords.push_back(std::tuple<util::EmoteData, QString>(emojiImage, QString()));
+        parsedWords.push_back(
+            std::tuple<util::EmoteData, QString>(this->emojiImages[emojiIndex], QString()));
 
         lastParsedEmojiEndIndex = currentParsedEmojiEndIndex;
 
@@ -501,6 +488,9 @@ void EmoteManager::loadBTTVEmotes()
         }
 
         this->bttvGlobalEmoteCodes = codes;
+
+        this->refreshGlobalEmoteTable();
+        this->emotesChanged();
     });
 }
 
@@ -535,17 +525,22 @@ void EmoteManager::loadFFZEmotes()
 
             this->ffzGlobalEmoteCodes = codes;
         }
+
+        this->refreshGlobalEmoteTable();
+        this->emotesChanged();
     });
 }
 
 // id is used for lookup
 // emoteName is used for giving a name to the emote in case it doesn't exist
-util::EmoteData EmoteManager::getTwitchEmoteById(long id, const QString &emoteName)
+util::EmoteData EmoteManager::getTwitchEmoteById(long id, const QStringRef &emoteNameRef)
 {
-    QString _emoteName = emoteName;
-    _emoteName.replace("<", "&lt;");
+    return _twitchEmoteFromCache.getOrAdd(id, [this, &emoteNameRef, &id] {
+        // the name is only needed the first time the emote is seen
+        QString emoteName = emoteNameRef.toString();
+        QString _emoteName = emoteName;
+        _emoteName.replace("<", "&lt;");
 
-    return _twitchEmoteFromCache.getOrAdd(id, [this, &emoteName, &_emoteName, &id] {
         util::EmoteData newEmoteData;
         newEmoteData.image1x = new Image(GetTwitchEmoteLink(id, "1.0"), 1, emoteName,
                                                    _emoteName + "<br/>Twitch Emote 1x");
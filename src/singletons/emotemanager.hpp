@@ -8,7 +8,9 @@
 #include "twitch/emotevalue.hpp"
 #include "twitch/twitchuser.hpp"
 #include "util/concurrentmap.hpp"
+#include "util/emojitrie.hpp"
 #include "util/emotemap.hpp"
+#include "util/emotetable.hpp"
 
 #include <QMap>
 #include <QMutex>
@@ -48,7 +50,7 @@ public:
 
     util::EmoteData getCheerImage(long long int amount, bool animated);
 
-    util::EmoteData getTwitchEmoteById(long int id, const QString &emoteName);
+    util::EmoteData getTwitchEmoteById(long int id, const QStringRef &emoteName);
 
     int getGeneration()
     {
@@ -62,6 +64,19 @@ public:
 
     boost::signals2::signal<void()> &getGifUpdateSignal();
 
+    // Merges the global emotes with the given channel emotes, channel maps may be null
+    std::shared_ptr<const util::EmoteTable> buildEmoteTable(const util::EmoteMap *bttvChannel,
+                                                            const util::EmoteMap *ffzChannel);
+
+    // Table of the global emotes, for messages that are not in a twitch channel
+    std::shared_ptr<const util::EmoteTable> getGlobalEmoteTable() const;
+
+    // Invoked on the gui thread after the global emotes were (re)loaded
+    boost::signals2::signal<void()> emotesChanged;
+
+    // Invoked on the gui thread after the bttv or ffz emotes of a channel were (re)loaded
+    boost::signals2::signal<void(const QString &channelName)> channelEmotesChanged;
+
     // Bit badge/emotes?
     util::ConcurrentMap<QString, messages::Image *> miscImageCache;
 
@@ -75,8 +90,9 @@ private:
     // shortCodeToEmoji maps strings like "sunglasses" to its emoji
     QMap<QString, EmojiData> emojiShortCodeToEmoji;
 
-    // Maps the first character of the emoji unicode string to a vector of possible emojis
-    QMap<QChar, QVector<EmojiData>> emojiFirstByte;
+    // Finds the emojis in a word, the values are indices into emojiImages
+    util::EmojiTrie emojiTrie;
+    std::vector<util::EmoteData> emojiImages;
 
     //            url      Emoji-one image
     util::EmoteMap emojis;
@@ -148,6 +164,12 @@ private:
     /// Chatterino emotes
     util::EmoteMap _chatterinoEmotes;
 
+    void refreshGlobalEmoteTable();
+
+    // starts out empty so parse contexts built before the emotes are loaded can use it
+    std::shared_ptr<const util::EmoteTable> globalEmoteTable =
+        std::make_shared<const util::EmoteTable>(util::EmoteTable::Sources());
+
     boost::signals2::signal<void()> gifUpdateTimerSignal;
     QTimer gifUpdateTimer;
     bool gifUpdateTimerInitiated = false;
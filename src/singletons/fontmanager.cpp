@@ -1,4 +1,5 @@
 #include "singletons/fontmanager.hpp"
+#include "util/wordwidthcache.hpp"
 
 #include <QDebug>
 #include <QtGlobal>
@@ -24,20 +25,31 @@ FontManager::FontManager()
     , currentFontSize("/appearance/currentFontSize", DEFAULT_FONT_SIZE)
 //    , currentFont(this->currentFontFamily.getValue().c_str(), currentFontSize.getValue())
 {
+    this->threadSettings = std::make_shared<ThreadSettings>(ThreadSettings{
+        this->currentFontFamily.getValue(), this->currentFontSize.getValue(), 0});
+
     this->currentFontFamily.connect([this](const std::string &newValue, auto) {
-        this->incGeneration();
-        //        this->currentFont.setFamily(newValue.c_str());
-        this->currentFontByDpi.clear();
-        this->fontChanged.invoke();
+        this->updateFont(newValue, this->currentFontSize.getValue());
     });
     this->currentFontSize.connect([this](const int &newValue, auto) {
-        this->incGeneration();
-        //        this->currentFont.setSize(newValue);
-        this->currentFontByDpi.clear();
-        this->fontChanged.invoke();
+        this->updateFont(this->currentFontFamily.getValue(), newValue);
     });
 }
 
+void FontManager::updateFont(const std::string &family, int size)
+{
+    std::shared_ptr<const ThreadSettings> settings =
+        std::make_shared<ThreadSettings>(ThreadSettings{family, size, this->generation + 1});
+
+    std::atomic_store(&this->threadSettings, settings);
+    this->generation++;
+
+    util::WordWidthCache::clear();
+
+    this->currentFontByDpi.clear();
+    this->fontChanged.invoke();
+}
+
 FontManager &FontManager::getInstance()
 {
     static FontManager instance;
@@ -57,6 +69,78 @@ QFontMetrics &FontManager::getFontMetrics(Type type, float dpi)
     return this->getCurrentFont(dpi).getFontMetrics(type);
 }
 
+const FontManager::FontData &FontManager::getThreadFontData(Type type, float dpi, int &generation)
+{
+    // QFontMetrics can't be shared between threads
+    struct ThreadFonts {
+        int generation = -1;
+        std::list<std::pair<float, Font>> fontByDpi;
+    };
+
+    thread_local ThreadFonts fonts;
+
+    auto settings = std::atomic_load(&this->threadSettings);
+
+    if (fonts.generation != settings->generation) {
+        fonts.generation = settings->generation;
+        fonts.fontByDpi.clear();
+    }
+
+    generation = fonts.generation;
+
+    for (auto &font : fonts.fontByDpi) {
+        if (font.first == dpi) {
+            return font.second.getFontData(type);
+        }
+    }
+
+    fonts.fontByDpi.push_back(
+        std::make_pair(dpi, Font(settings->family.c_str(), settings->size * dpi)));
+
+    return fonts.fontByDpi.back().second.getFontData(type);
+}
+
+FontManager::FontData::FontData(QFont &&_font)
+    : font(_font)
+    , metrics(this->font)
+{
+    this->updateMetrics();
+}
+
+void FontManager::FontData::updateMetrics()
+{
+    this->metrics = QFontMetrics(this->font);
+
+    QFontMetricsF metricsF(this->font);
+
+    for (int i = 0; i < 128; i++) {
+        this->asciiAdvances[i] = qRound(metricsF.width(QChar(i)) * 64);
+    }
+}
+
+bool FontManager::FontData::getAsciiWidth(const QString &text, int &width) const
+{
+    const ushort *units = reinterpret_cast<const ushort *>(text.constData());
+    int size = text.size();
+
+    // no branches and integer sums in the loop so the compiler can vectorize it
+    ushort nonAscii = 0;
+    int sum = 0;
+
+    for (int i = 0; i < size; i++) {
+        nonAscii |= units[i];
+        sum += this->asciiAdvances[units[i] & 0x7f];
+    }
+
+    if ((nonAscii & 0xff80) != 0) {
+        return false;
+    }
+
+    width = (sum + 32) / 64;
+
+    return true;
+}
+
 FontManager::FontData &FontManager::Font::getFontData(Type type)
 {
     switch (type) {
@@ -5,6 +5,12 @@
 #include <pajlada/settings/setting.hpp>
 #include <pajlada/signals/signal.hpp>
 
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+
 namespace chatterino {
 namespace singletons {
 
@@ -28,17 +34,36 @@ public:
     // FontManager is initialized only once, on first use
     static FontManager &getInstance();
 
+    // only on the gui thread
     QFont &getFont(Type type, float dpi);
     QFontMetrics &getFontMetrics(Type type, float dpi);
 
-    int getGeneration() const
-    {
-        return this->generation;
-    }
+    struct FontData {
+        FontData(QFont &&_font);
+
+        // returns false if the text contains anything but ascii, otherwise sets `width` to the
+        // sum of the advances of its characters. That ignores kerning, so it's an approximation
+        // of what metrics.width() returns.
+        bool getAsciiWidth(const QString &text, int &width) const;
+
+        void updateMetrics();
+
+        QFont font;
+        QFontMetrics metrics;
+
+        // advances of the ascii characters measured one by one, in 1/64 pixels like Qt's QFixed
+        std::array<int, 128> asciiAdvances;
+    };
+
+    // Like getFontMetrics, but can be called from any thread. Every thread has its own fonts and
+    // metrics, they are rebuilt the first time they are used after the font changed.
+    // `generation` is set to the generation the returned font belongs to.
+    const FontData &getThreadFontData(Type type, float dpi, int &generation);
 
-    void incGeneration()
+    // incremented whenever the font changes, safe to call from any thread
+    int getGeneration() const
     {
-        this->generation++;
+        return this->generation.load();
     }
 
     pajlada::Settings::Setting<std::string> currentFontFamily;
@@ -47,17 +72,6 @@ public:
     pajlada::Signals::NoArgSignal fontChanged;
 
 private:
-    struct FontData {
-        FontData(QFont &&_font)
-            : font(_font)
-            , metrics(this->font)
-        {
-        }
-
-        QFont font;
-        QFontMetrics metrics;
-    };
-
     struct Font {
         Font() = delete;
 
@@ -100,13 +114,13 @@ private:
 
         void updateMetrics()
         {
-            this->small.metrics = QFontMetrics(this->small.font);
-            this->mediumSmall.metrics = QFontMetrics(this->mediumSmall.font);
-            this->medium.metrics = QFontMetrics(this->medium.font);
-            this->mediumBold.metrics = QFontMetrics(this->mediumBold.font);
-            this->mediumItalic.metrics = QFontMetrics(this->mediumItalic.font);
-            this->large.metrics = QFontMetrics(this->large.font);
-            this->veryLarge.metrics = QFontMetrics(this->veryLarge.font);
+            this->small.updateMetrics();
+            this->mediumSmall.updateMetrics();
+            this->medium.updateMetrics();
+            this->mediumBold.updateMetrics();
+            this->mediumItalic.updateMetrics();
+            this->large.updateMetrics();
+            this->veryLarge.updateMetrics();
         }
 
         FontData &getFontData(Type type);
@@ -125,12 +139,25 @@ private:
 
     Font &getCurrentFont(float dpi);
 
+    // what the fonts of the other threads are built from
+    struct ThreadSettings {
+        std::string family;
+        int size;
+        int generation;
+    };
+
+    // sets the generation of the settings first, so a thread that sees the new generation also
+    // sees the new fonts
+    void updateFont(const std::string &family, int size);
+
+    std::shared_ptr<const ThreadSettings> threadSettings;
+
     // Future plans:
     // Could have multiple fonts in here, such as "Menu font", "Application font", "Chat font"
 
     std::list<std::pair<float, Font>> currentFontByDpi;
 
-    int generation = 0;
+    std::atomic<int> generation{0};
 };
 }
 
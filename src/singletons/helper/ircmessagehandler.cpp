@@ -9,6 +9,7 @@
 #include "singletons/resourcemanager.hpp"
 #include "singletons/windowmanager.hpp"
 #include "twitch/twitchchannel.hpp"
+#include "util/irctags.hpp"
 
 using namespace chatterino::messages;
 
@@ -80,16 +81,11 @@ void IrcMessageHandler::handleClearChatMessage(Communi::IrcMessage *message)
 
     // get username, duration and message of the timed out user
     QString username = message->parameter(1);
-    QString durationInSeconds, reason;
-    QVariant v = message->tag("ban-duration");
-    if (v.isValid()) {
-        durationInSeconds = v.toString();
-    }
-
-    v = message->tag("ban-reason");
-    if (v.isValid()) {
-        reason = v.toString();
-    }
+    util::Symbol user(username);
+    QByteArray ircData = message->toData();
+    util::IrcTags tags(ircData);
+    QString durationInSeconds = tags.banDuration.toString();
+    QString reason = tags.banReason.toString();
 
     // add the notice that the user has been timed out
     LimitedQueueSnapshot<MessagePtr> snapshot = c->getMessageSnapshot();
@@ -97,7 +93,7 @@ void IrcMessageHandler::handleClearChatMessage(Communi::IrcMessage *message)
     int snapshotLength = snapshot.getLength();
 
     for (int i = std::max(0, snapshotLength - 20); i < snapshotLength; i++) {
-        if (snapshot[i]->hasFlags(Message::Timeout) && snapshot[i]->loginName == username) {
+        if (snapshot[i]->hasFlags(Message::Timeout) && snapshot[i]->getTimeoutUser() == user) {
             MessagePtr replacement(
                 Message::createTimeoutMessage(username, durationInSeconds, reason, true));
             c->replaceMessage(snapshot[i], replacement);
@@ -110,15 +106,38 @@ void IrcMessageHandler::handleClearChatMessage(Communi::IrcMessage *message)
         c->addMessage(Message::createTimeoutMessage(username, durationInSeconds, reason, false));
     }
 
-    // disable the messages from the user
-    for (int i = 0; i < snapshotLength; i++) {
-        if (!snapshot[i]->hasFlags(Message::Timeout) && snapshot[i]->loginName == username) {
-            snapshot[i]->setFlags(Message::Disabled);
-        }
+    // disable the messages from the user, the views get repainted with the next frame
+    c->disableMessagesFromUser(user);
+}
+
+void IrcMessageHandler::handleClearMessageMessage(Communi::IrcMessage *message)
+{
+    assert(message->parameters().length() >= 1);
+
+    auto rawChannelName = message->parameter(0);
+
+    assert(rawChannelName.length() >= 2);
+
+    auto trimmedChannelName = rawChannelName.mid(1);
+
+    auto c = this->channelManager.getTwitchChannel(trimmedChannelName);
+
+    if (!c) {
+        debug::Log(
+            "[IrcMessageHandler:handleClearMessageMessage] Channel {} not found in channel manager",
+            trimmedChannelName);
+        return;
+    }
+
+    // disable the deleted message
+    QByteArray ircData = message->toData();
+    MessagePtr deleted = c->findMessage(util::IrcTags(ircData).targetMsgId.toString());
+
+    if (!deleted) {
+        return;
     }
 
-    // refresh all
-    WindowManager::getInstance().repaintVisibleChatWidgets(c.get());
+    c->disableMessage(deleted);
 }
 
 void IrcMessageHandler::handleUserStateMessage(Communi::IrcMessage *message)
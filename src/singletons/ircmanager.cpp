@@ -10,7 +10,6 @@
 #include "singletons/resourcemanager.hpp"
 #include "singletons/settingsmanager.hpp"
 #include "singletons/windowmanager.hpp"
-#include "twitch/twitchmessagebuilder.hpp"
 #include "twitch/twitchuser.hpp"
 #include "util/urlfetch.hpp"
 
@@ -253,9 +252,7 @@ void IrcManager::privateMessageReceived(Communi::IrcPrivateMessage *message)
 
     messages::MessageParseArgs args;
 
-    twitch::TwitchMessageBuilder builder(c.get(), message, args);
-
-    c->addMessage(builder.parse());
+    this->parsePipeline.push(c, message->toData(), args);
 }
 
 void IrcManager::messageReceived(Communi::IrcMessage *message)
@@ -267,10 +264,39 @@ void IrcManager::messageReceived(Communi::IrcMessage *message)
 
     const QString &command = message->command();
 
+    // these change the messages of the channel, so they wait for the chat messages that arrived
+    // before them in that channel
+    if (command == "CLEARCHAT" || command == "CLEARMSG" || command == "USERNOTICE") {
+        auto channel = this->channelManager.getTwitchChannel(message->parameter(0).mid(1));
+
+        if (channel) {
+            QByteArray ircData = message->toData();
+
+            this->parsePipeline.pushEvent(channel, [this, ircData] {
+                // the original message is deleted by communi once this handler returns
+                std::unique_ptr<Communi::IrcMessage> copy(
+                    Communi::IrcMessage::fromData(ircData, nullptr));
+
+                this->handleMessage(copy.get());
+            });
+
+            return;
+        }
+    }
+
+    this->handleMessage(message);
+}
+
+void IrcManager::handleMessage(Communi::IrcMessage *message)
+{
+    const QString &command = message->command();
+
     if (command == "ROOMSTATE") {
         helper::IrcMessageHandler::getInstance().handleRoomStateMessage(message);
     } else if (command == "CLEARCHAT") {
         helper::IrcMessageHandler::getInstance().handleClearChatMessage(message);
+    } else if (command == "CLEARMSG") {
+        helper::IrcMessageHandler::getInstance().handleClearMessageMessage(message);
     } else if (command == "USERSTATE") {
         helper::IrcMessageHandler::getInstance().handleUserStateMessage(message);
     } else if (command == "WHISPER") {
@@ -404,6 +430,11 @@ Communi::IrcConnection *IrcManager::getReadConnection()
     return this->readConnection.get();
 }
 
+void IrcManager::runOnParseThreads(std::function<void()> task)
+{
+    this->parsePipeline.runTask(std::move(task));
+}
+
 void
 IrcManager::addFakeMessage(const QString &data)
 {
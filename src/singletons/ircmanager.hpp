@@ -3,6 +3,7 @@
 #define TWITCH_MAX_MESSAGELENGTH 500
 
 #include "messages/message.hpp"
+#include "twitch/twitchparsepipeline.hpp"
 #include "twitch/twitchuser.hpp"
 
 #include <ircconnection.h>
@@ -13,6 +14,7 @@
 #include <QString>
 #include <pajlada/signals/signal.hpp>
 
+#include <functional>
 #include <memory>
 #include <mutex>
 
@@ -53,6 +55,9 @@ public:
 
     Communi::IrcConnection *getReadConnection();
 
+    // runs the task on the threads that parse the chat messages
+    void runOnParseThreads(std::function<void()> task);
+
     /// Debug function
     void addFakeMessage(const QString &data);
 
@@ -83,12 +88,16 @@ private:
     void beginConnecting();
 
     void messageReceived(Communi::IrcMessage *message);
+    void handleMessage(Communi::IrcMessage *message);
 
     void writeConnectionMessageReceived(Communi::IrcMessage *message);
 
     void onConnected();
     void onDisconnected();
 
+    // chat messages are parsed off the gui thread
+    twitch::TwitchParsePipeline parsePipeline;
+
 private:
     QByteArray messageSuffix;
 };
@@ -1,4 +1,5 @@
 #include "pathmanager.hpp"
+#include "messages/coldmessagestore.hpp"
 
 #include <QDir>
 #include <QStandardPaths>
@@ -50,6 +51,16 @@ bool PathManager::init(int argc, char **argv)
         return false;
     }
 
+    this->historyFolderPath = rootPath + "/History";
+
+    if (!QDir().mkpath(this->historyFolderPath)) {
+        printf("Error creating directory: %s\n", qPrintable(this->historyFolderPath));
+        return false;
+    }
+
+    // the history of a session is normally removed when it ends
+    messages::ColdMessageStore::removeStaleSessions(this->historyFolderPath);
+
     return true;
 }
 
@@ -16,6 +16,9 @@ public:
 
     QString settingsFolderPath;
     QString customFolderPath;
+
+    // messages removed from the channels, cleared every session
+    QString historyFolderPath;
 };
 
 }  // namespace singletons
@@ -1,4 +1,6 @@
 #include "resourcemanager.hpp"
+#include "twitch/twitchbadgeresolver.hpp"
+#include "twitch/twitchcheermotematcher.hpp"
 #include "util/urlfetch.hpp"
 
 #include <QPixmap>
@@ -286,6 +288,8 @@ ResourceManager::ResourceManager()
     , buttonBan(lli(":/images/button_ban.png", 0.25))
     , buttonTimeout(lli(":/images/button_timeout.png", 0.25))
 {
+    this->globalBadgeResolver = this->makeBadgeResolver(nullptr);
+
     this->loadDynamicTwitchBadges();
 
     this->loadChatterinoBadges();
@@ -308,6 +312,112 @@ ResourceManager::BadgeVersion::BadgeVersion(QJsonObject &&root)
 {
 }
 
+std::shared_ptr<const twitch::TwitchBadgeResolver> ResourceManager::getBadgeResolver(
+    const QString &roomID)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto it = this->channels.find(roomID);
+
+    if (it == this->channels.end() || it->second.badgeResolver == nullptr) {
+        return this->globalBadgeResolver;
+    }
+
+    return it->second.badgeResolver;
+}
+
+std::shared_ptr<const twitch::TwitchCheermoteMatcher> ResourceManager::getCheermoteMatcher(
+    const QString &roomID)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto it = this->channels.find(roomID);
+
+    if (it == this->channels.end()) {
+        return nullptr;
+    }
+
+    return it->second.cheermoteMatcher;
+}
+
+std::shared_ptr<const twitch::TwitchBadgeResolver> ResourceManager::makeBadgeResolver(
+    const Channel *channel) const
+{
+    using messages::MessageElement;
+
+    twitch::TwitchBadgeResolver::Badges badges;
+
+    auto addBadge = [&badges](const std::string &key, messages::Image *image,
+                              MessageElement::Flags flags, const QString &tooltip) {
+        util::Symbol symbol = tooltip.isEmpty() ? util::Symbol() : util::Symbol(tooltip);
+
+        badges.emplace_back(QByteArray::fromStdString(key),
+                            twitch::ResolvedBadge{image, flags, symbol});
+    };
+
+    auto addBadgeSet = [&addBadge](const std::string &setKey, const BadgeSet &set,
+                                   MessageElement::Flags flags, bool tooltip) {
+        for (const auto &version : set.versions) {
+            addBadge(setKey + "/" + version.first, version.second.badgeImage1x, flags,
+                     tooltip ? "Twitch " + QString::fromStdString(version.second.title)
+                             : QString());
+        }
+    };
+
+    // the first badge with a key wins, so the hardcoded ones come first, then the ones of the
+    // channel
+    addBadge("staff/1", this->badgeStaff, MessageElement::BadgeGlobalAuthority, "Twitch Staff");
+    addBadge("admin/1", this->badgeAdmin, MessageElement::BadgeGlobalAuthority, "Twitch Admin");
+    addBadge("global_mod/1", this->badgeGlobalModerator, MessageElement::BadgeGlobalAuthority,
+             "Twitch Global Moderator");
+    // TODO: Implement custom FFZ moderator badge
+    addBadge("moderator/1", this->badgeModerator, MessageElement::BadgeChannelAuthority,
+             "Twitch Channel Moderator");
+    addBadge("turbo/1", this->badgeTurbo, MessageElement::BadgeGlobalAuthority,
+             "Twitch Turbo Subscriber");
+    addBadge("broadcaster/1", this->badgeBroadcaster, MessageElement::BadgeChannelAuthority,
+             "Twitch Broadcaster");
+    addBadge("premium/1", this->badgePremium, MessageElement::BadgeVanity,
+             "Twitch Prime Subscriber");
+    addBadge("partner/1", this->badgeVerified, MessageElement::BadgeVanity, "Twitch Verified");
+
+    twitch::ResolvedBadge subscriberFallback;
+
+    if (channel != nullptr) {
+        auto subscriberIt = channel->badgeSets.find("subscriber");
+
+        if (subscriberIt != channel->badgeSets.end()) {
+            addBadgeSet("subscriber", subscriberIt->second, MessageElement::BadgeSubscription,
+                        true);
+        }
+
+        auto bitsIt = channel->badgeSets.find("bits");
+
+        if (bitsIt != channel->badgeSets.end()) {
+            addBadgeSet("bits", bitsIt->second, MessageElement::BadgeVanity, false);
+        }
+
+        if (channel->loaded) {
+            subscriberFallback = twitch::ResolvedBadge{
+                this->badgeSubscriber, MessageElement::BadgeSubscription,
+                util::Symbol(QStringLiteral("Twitch Subscriber"))};
+        }
+    }
+
+    for (const auto &set : this->badgeSets) {
+        // subscriber badges only come from the channel
+        if (set.first == "subscriber") {
+            continue;
+        }
+
+        bool bits = set.first == "bits";
+
+        addBadgeSet(set.first, set.second, MessageElement::BadgeVanity, !bits);
+    }
+
+    return std::make_shared<twitch::TwitchBadgeResolver>(badges, subscriberFallback);
+}
+
 void ResourceManager::loadChannelData(const QString &roomID, bool bypassCache)
 {
     qDebug() << "Load channel data for" << roomID;
@@ -320,6 +430,8 @@ void ResourceManager::loadChannelData(const QString &roomID, bool bypassCache)
     req.getJSON([this, roomID](QJsonObject &root) {
         QJsonObject sets = root.value("badge_sets").toObject();
 
+        std::lock_guard<std::mutex> lock(this->mutex);
+
         ResourceManager::Channel &ch = this->channels[roomID];
 
         for (QJsonObject::iterator it = sets.begin(); it != sets.end(); ++it) {
@@ -338,20 +450,22 @@ void ResourceManager::loadChannelData(const QString &roomID, bool bypassCache)
         }
 
         ch.loaded = true;
+        ch.badgeResolver = this->makeBadgeResolver(&ch);
     });
 
     QString cheermoteURL = "https://api.twitch.tv/kraken/bits/actions?channel_id=" + roomID;
 
     util::twitch::get2(
         cheermoteURL, QThread::currentThread(), [this, roomID](const rapidjson::Document &d) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
             ResourceManager::Channel &ch = this->channels[roomID];
 
             ParseCheermoteSets(ch.jsonCheermoteSets, d);
 
             for (auto &set : ch.jsonCheermoteSets) {
                 CheermoteSet cheermoteSet;
-                cheermoteSet.regex =
-                    QRegularExpression("^" + set.prefix.toLower() + "([1-9][0-9]*)$");
+                cheermoteSet.prefix = set.prefix;
 
                 for (auto &tier : set.tiers) {
                     Cheermote cheermote;
@@ -380,6 +494,9 @@ void ResourceManager::loadChannelData(const QString &roomID, bool bypassCache)
 
                 ch.cheermoteSets.emplace_back(cheermoteSet);
             }
+
+            ch.cheermoteMatcher =
+                std::make_shared<twitch::TwitchCheermoteMatcher>(ch.cheermoteSets);
         });
 }
 
@@ -392,6 +509,8 @@ void ResourceManager::loadDynamicTwitchBadges()
     req.getJSON([this](QJsonObject &root) {
         QJsonObject sets = root.value("badge_sets").toObject();
         qDebug() << "badges fetched";
+
+        std::lock_guard<std::mutex> lock(this->mutex);
         for (QJsonObject::iterator it = sets.begin(); it != sets.end(); ++it) {
             QJsonObject versions = it.value().toObject().value("versions").toObject();
 
@@ -408,12 +527,25 @@ void ResourceManager::loadDynamicTwitchBadges()
         }
 
         this->dynamicBadgesLoaded = true;
+
+        // every resolver contains the global badges
+        this->globalBadgeResolver = this->makeBadgeResolver(nullptr);
+
+        for (auto &channel : this->channels) {
+            if (channel.second.badgeResolver != nullptr) {
+                channel.second.badgeResolver = this->makeBadgeResolver(&channel.second);
+            }
+        }
     });
 }
 
 void ResourceManager::loadChatterinoBadges()
 {
-    this->chatterinoBadges.clear();
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->chatterinoBadges.clear();
+    }
 
     static QString url("https://fourtf.com/chatterino/badges.json");
 
@@ -423,6 +555,8 @@ void ResourceManager::loadChatterinoBadges()
     req.getJSON([this](QJsonObject &root) {
         QJsonArray badgeVariants = root.value("badges").toArray();
         qDebug() << "chatbadges fetched";
+
+        std::lock_guard<std::mutex> lock(this->mutex);
         for (QJsonArray::iterator it = badgeVariants.begin(); it != badgeVariants.end(); ++it) {
             QJsonObject badgeVariant = it->toObject();
             const std::string badgeVariantTooltip =
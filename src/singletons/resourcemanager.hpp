@@ -9,6 +9,11 @@
 #include <mutex>
 
 namespace chatterino {
+namespace twitch {
+class TwitchBadgeResolver;
+class TwitchCheermoteMatcher;
+}  // namespace twitch
+
 namespace singletons {
 
 class ResourceManager
@@ -18,6 +23,10 @@ class ResourceManager
 public:
     static ResourceManager &getInstance();
 
+    // Guards the badges, the channel data and the chatterino badges. They are written by the
+    // network callbacks on the gui thread and read by the message parser threads.
+    std::mutex mutex;
+
     messages::Image *badgeStaff;
     messages::Image *badgeAdmin;
     messages::Image *badgeGlobalModerator;
@@ -96,7 +105,7 @@ public:
     };
 
     struct CheermoteSet {
-        QRegularExpression regex;
+        QString prefix;
         std::vector<Cheermote> cheermotes;
     };
 
@@ -106,11 +115,26 @@ public:
         std::vector<CheermoteSet> cheermoteSets;
 
         bool loaded = false;
+
+        // null until the badges of the channel are loaded
+        std::shared_ptr<const twitch::TwitchBadgeResolver> badgeResolver;
+
+        // null until the cheermotes of the channel are loaded
+        std::shared_ptr<const twitch::TwitchCheermoteMatcher> cheermoteMatcher;
     };
 
     //       channelId
     std::map<QString, Channel> channels;
 
+    // the badges of the channel layered over the global ones, never null. Locks the mutex, the
+    // returned resolver can be used without it
+    std::shared_ptr<const twitch::TwitchBadgeResolver> getBadgeResolver(const QString &roomID);
+
+    // null if the room has no cheermotes loaded. Locks the mutex, the returned matcher can be used
+    // without it
+    std::shared_ptr<const twitch::TwitchCheermoteMatcher> getCheermoteMatcher(
+        const QString &roomID);
+
     // Chatterino badges
     struct ChatterinoBadge {
         ChatterinoBadge(const std::string &_tooltip, messages::Image *_image)
@@ -129,6 +153,14 @@ public:
     void loadChannelData(const QString &roomID, bool bypassCache = false);
     void loadDynamicTwitchBadges();
     void loadChatterinoBadges();
+
+private:
+    // for rooms that have no channel badges loaded
+    std::shared_ptr<const twitch::TwitchBadgeResolver> globalBadgeResolver;
+
+    // channel is nullptr for the global resolver, has to be called with the mutex locked
+    std::shared_ptr<const twitch::TwitchBadgeResolver> makeBadgeResolver(
+        const Channel *channel) const;
 };
 
 }  // namespace singletons
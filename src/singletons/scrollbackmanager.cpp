@@ -0,0 +1,185 @@
+#include "singletons/scrollbackmanager.hpp"
+#include "channel.hpp"
+#include "singletons/settingsmanager.hpp"
+#include "widgets/helper/channelview.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace chatterino {
+namespace singletons {
+
+namespace {
+
+const int rebalanceInterval = 5000;
+
+const size_t minimumMessageLimit = 100;
+const size_t maximumMessageLimit = 10000;
+
+// used for channels that don't have any messages yet
+const size_t defaultMessageSize = 2048;
+
+// visible channels get this many times the share of hidden ones
+const float visibleWeight = 4.f;
+
+// weight of the newest sample in the activity average
+const float activitySmoothing = 0.3f;
+
+}  // namespace
+
+ScrollbackManager &ScrollbackManager::getInstance()
+{
+    static ScrollbackManager instance(SettingManager::getInstance());
+    return instance;
+}
+
+ScrollbackManager::ScrollbackManager(SettingManager &_settingManager)
+    : settingManager(_settingManager)
+{
+    QObject::connect(&this->rebalanceTimer, &QTimer::timeout, [this] {
+        this->rebalance();  //
+    });
+    this->rebalanceTimer.start(rebalanceInterval);
+
+    this->settingManager.scrollbackMemoryBudget.connect([this](const int &, auto) {
+        this->rebalance();  //
+    });
+}
+
+void ScrollbackManager::addChannel(const std::shared_ptr<Channel> &channel)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->channels[channel] = 0.f;
+}
+
+void ScrollbackManager::addView(widgets::ChannelView *view)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->views.insert(view);
+}
+
+void ScrollbackManager::removeView(widgets::ChannelView *view)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->views.erase(view);
+}
+
+size_t ScrollbackManager::getBudget() const
+{
+    return (size_t)std::max(1, this->settingManager.scrollbackMemoryBudget.getValue()) * 1024 *
+           1024;
+}
+
+void ScrollbackManager::rebalance()
+{
+    struct Entry {
+        // keeps the channel alive until its limit was set
+        std::shared_ptr<Channel> channel;
+        size_t messageCount;
+        size_t approximateSize;
+        bool visible;
+        float activity;
+        float weight;
+    };
+
+    std::vector<Entry> entries;
+    float totalWeight = 0.f;
+    size_t budget = this->getBudget();
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        entries.reserve(this->channels.size());
+
+        for (auto it = this->channels.begin(); it != this->channels.end();) {
+            std::shared_ptr<Channel> channel = it->first.lock();
+
+            if (!channel) {
+                it = this->channels.erase(it);
+                continue;
+            }
+
+            float &activity = it->second;
+            it++;
+
+            activity = activity * (1.f - activitySmoothing) +
+                       channel->takeAddedMessageCount() * activitySmoothing;
+
+            Entry entry;
+            entry.channel = channel;
+            entry.messageCount = channel->getMessageSnapshot().getLength();
+            entry.approximateSize = channel->getApproximateMessagesSize();
+            entry.visible = false;
+            entry.activity = activity;
+
+            for (widgets::ChannelView *view : this->views) {
+                if (view->getChannel() == channel) {
+                    entry.approximateSize += view->getApproximateLayoutsSize();
+                    entry.visible |= view->isVisible();
+                }
+            }
+
+            // busy channels need more messages to cover the same amount of time, but a channel
+            // with ten times the messages shouldn't take ten times the memory
+            entry.weight =
+                (entry.visible ? visibleWeight : 1.f) * (1.f + std::log2(1.f + activity));
+            totalWeight += entry.weight;
+
+            entries.push_back(entry);
+        }
+    }
+
+    std::vector<ChannelInfo> infos;
+    infos.reserve(entries.size());
+    size_t totalSize = 0;
+
+    for (const Entry &entry : entries) {
+        size_t share = (size_t)(budget * (entry.weight / totalWeight));
+        size_t messageSize = entry.messageCount == 0
+                                 ? defaultMessageSize
+                                 : std::max<size_t>(1, entry.approximateSize / entry.messageCount);
+
+        size_t limit = std::min(maximumMessageLimit,
+                                std::max(minimumMessageLimit, share / messageSize));
+        size_t currentLimit = entry.channel->getMessageLimit();
+
+        // shrinking throws away messages, so don't follow small fluctuations in message sizes
+        if (limit > currentLimit || limit + currentLimit / 10 < currentLimit) {
+            entry.channel->setMessageLimit(limit);
+            currentLimit = limit;
+        }
+
+        totalSize += entry.approximateSize;
+        infos.push_back({entry.channel->name, entry.messageCount, entry.approximateSize,
+                         currentLimit, entry.visible, entry.activity});
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->channelInfos = std::move(infos);
+        this->approximateTotalSize = totalSize;
+    }
+
+    this->rebalanced.invoke();
+}
+
+std::vector<ScrollbackManager::ChannelInfo> ScrollbackManager::getChannelInfos()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    return this->channelInfos;
+}
+
+size_t ScrollbackManager::getApproximateTotalSize()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    return this->approximateTotalSize;
+}
+
+}  // namespace singletons
+}  // namespace chatterino
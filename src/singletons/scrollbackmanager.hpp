@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QString>
+#include <QTimer>
+#include <pajlada/signals/signal.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace chatterino {
+
+class Channel;
+
+namespace widgets {
+class ChannelView;
+}  // namespace widgets
+
+namespace singletons {
+
+class SettingManager;
+
+// Shares the scrollback memory budget between all channels.
+//
+// Every few seconds the approximate size of each channel (messages, their elements, the message
+// layouts of every view showing the channel and their pixmap buffers) is measured. Each channel
+// gets a share of the budget weighted by whether it is visible and how many messages it
+// received recently, which is then converted to a message limit using the channel's average
+// message size.
+class ScrollbackManager
+{
+    explicit ScrollbackManager(SettingManager &_settingManager);
+
+public:
+    static ScrollbackManager &getInstance();
+
+    struct ChannelInfo {
+        QString name;
+        size_t messageCount;
+        size_t approximateSize;
+        size_t messageLimit;
+        bool visible;
+        float activity;
+    };
+
+    // only for the channels owned by the ChannelManager that receive messages, transient
+    // channels like the ones of the search and emote popups keep their fixed limit
+    // channels are dropped once they were destroyed
+    void addChannel(const std::shared_ptr<Channel> &channel);
+
+    void addView(widgets::ChannelView *view);
+    void removeView(widgets::ChannelView *view);
+
+    void rebalance();
+
+    std::vector<ChannelInfo> getChannelInfos();
+    size_t getApproximateTotalSize();
+    size_t getBudget() const;
+
+    pajlada::Signals::NoArgSignal rebalanced;
+
+private:
+    SettingManager &settingManager;
+    QTimer rebalanceTimer;
+
+    std::mutex mutex;
+
+    // value is the smoothed amount of messages received per rebalance interval
+    std::map<std::weak_ptr<Channel>, float, std::owner_less<std::weak_ptr<Channel>>> channels;
+    std::set<widgets::ChannelView *> views;
+
+    std::vector<ChannelInfo> channelInfos;
+    size_t approximateTotalSize = 0;
+};
+
+}  // namespace singletons
+}  // namespace chatterino
@@ -1,6 +1,8 @@
 #include "singletons/settingsmanager.hpp"
 #include "debug/log.hpp"
+#include "singletons/emotemanager.hpp"
 #include "singletons/pathmanager.hpp"
+#include "singletons/thememanager.hpp"
 
 using namespace chatterino::messages;
 
@@ -26,6 +28,30 @@ SettingManager::SettingManager()
     this->wordMaskListener.cb = [this](auto) {
         this->updateWordTypeMask();  //
     };
+
+    this->highlightEngine = std::make_shared<HighlightEngine>();
+
+    this->highlightListener.addSetting(this->highlightProperties);
+    this->highlightListener.addSetting(this->highlightUserBlacklist);
+    this->highlightListener.addSetting(this->enableHighlightsSelf);
+    this->highlightListener.addSetting(this->enableHighlightSound);
+    this->highlightListener.addSetting(this->enableHighlightTaskbar);
+    this->highlightListener.addSetting(this->currentUsername);
+    this->highlightListener.cb = [this](auto) {
+        this->updateHighlightEngine();  //
+    };
+
+    // completed in init(), the emote manager can't be created before the settings
+    auto context = std::make_shared<ParseContext>();
+    context->highlightEngine = this->highlightEngine;
+    this->parseContext = context;
+
+    // the highlight settings update the context through updateHighlightEngine
+    this->parseContextListener.addSetting(this->usernameDisplayMode);
+    this->parseContextListener.addSetting(this->enableHighlights);
+    this->parseContextListener.cb = [this](auto) {
+        this->updateParseContext();  //
+    };
 }
 
 MessageElement::Flags SettingManager::getWordTypeMask()
@@ -43,6 +69,15 @@ void SettingManager::init()
     QString settingsPath = PathManager::getInstance().settingsFolderPath + "/settings.json";
 
     pajlada::Settings::SettingManager::load(qPrintable(settingsPath));
+
+    this->updateHighlightEngine();
+
+    ThemeManager::getInstance().updated.connect([this] {
+        this->updateParseContext();  //
+    });
+    EmoteManager::getInstance().emotesChanged.connect([this] {
+        this->updateParseContext();  //
+    });
 }
 
 void SettingManager::updateWordTypeMask()
@@ -58,6 +93,7 @@ void SettingManager::updateWordTypeMask()
     newMaskUint |= enableFfzEmotes ? MessageElement::FfzEmoteImage : MessageElement::FfzEmoteText;
     newMaskUint |=
         enableBttvEmotes ? MessageElement::BttvEmoteImage : MessageElement::BttvEmoteText;
+    newMaskUint |= MessageElement::ChatterinoEmoteImage;
     newMaskUint |= enableEmojis ? MessageElement::EmojiImage : MessageElement::EmojiText;
 
     newMaskUint |= MessageElement::BitsAmount;
@@ -80,6 +116,52 @@ void SettingManager::updateWordTypeMask()
     }
 }
 
+std::shared_ptr<const HighlightEngine> SettingManager::getHighlightEngine() const
+{
+    return std::atomic_load(&this->highlightEngine);
+}
+
+void SettingManager::updateHighlightEngine()
+{
+    auto phrases = this->highlightProperties.getValue();
+
+    QString username = QString::fromStdString(this->currentUsername.getValue());
+
+    if (this->enableHighlightsSelf && !username.isEmpty()) {
+        HighlightPhrase selfHighlight;
+        selfHighlight.key = username;
+        selfHighlight.sound = this->enableHighlightSound;
+        selfHighlight.alert = this->enableHighlightTaskbar;
+        phrases.emplace_back(std::move(selfHighlight));
+    }
+
+    std::shared_ptr<const HighlightEngine> engine = std::make_shared<HighlightEngine>(
+        std::move(phrases), this->highlightUserBlacklist.getValue());
+
+    std::atomic_store(&this->highlightEngine, engine);
+
+    this->updateParseContext();
+}
+
+std::shared_ptr<const ParseContext> SettingManager::getParseContext() const
+{
+    return std::atomic_load(&this->parseContext);
+}
+
+void SettingManager::updateParseContext()
+{
+    auto context = std::make_shared<ParseContext>();
+
+    context->currentUsername = QString::fromStdString(this->currentUsername.getValue());
+    context->usernameDisplayMode = this->usernameDisplayMode;
+    context->enableHighlights = this->enableHighlights;
+    context->highlightEngine = this->getHighlightEngine();
+    context->globalEmoteTable = EmoteManager::getInstance().getGlobalEmoteTable();
+    context->systemTextColor = ThemeManager::getInstance().messages.textColors.system;
+
+    std::atomic_store(&this->parseContext, std::shared_ptr<const ParseContext>(context));
+}
+
 void SettingManager::saveSnapshot()
 {
     rapidjson::Document *d = new rapidjson::Document(rapidjson::kObjectType);
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "messages/highlightengine.hpp"
 #include "messages/highlightphrase.hpp"
 #include "messages/messageelement.hpp"
+#include "messages/parsecontext.hpp"
 #include "singletons/helper/chatterinosetting.hpp"
 
 #include <pajlada/settings/setting.hpp>
@@ -44,6 +46,8 @@ public:
     BoolSetting enableSmoothScrollingNewMessages = {"/appearance/smoothScrollingNewMessages",
                                                     false};
     // BoolSetting useCustomWindowFrame = {"/appearance/useCustomWindowFrame", false};
+    // TwitchMessageBuilder::UsernameDisplayMode
+    IntSetting usernameDisplayMode = {"/appearance/messages/usernameDisplayMode", 3};
 
     /// Behaviour
     BoolSetting allowDuplicateMessages = {"/behaviour/allowDuplicateMessages", true};
@@ -52,6 +56,8 @@ public:
     QStringSetting streamlinkPath = {"/behaviour/streamlink/path", ""};
     QStringSetting preferredQuality = {"/behaviour/streamlink/quality", "Choose"};
     BoolSetting pauseChatHover = {"/behaviour/pauseChatHover", false};
+    // in megabytes, shared between all channels by the ScrollbackManager
+    IntSetting scrollbackMemoryBudget = {"/behaviour/scrollbackMemoryBudget", 256};
 
     /// Commands
     BoolSetting allowCommandsAtEnd = {"/commands/allowCommandsAtEnd", false};
@@ -102,6 +108,16 @@ public:
     }
     void updateWordTypeMask();
 
+    // Compiled from the highlight settings, replaced whenever one of them changes. Safe to call
+    // from any thread.
+    std::shared_ptr<const messages::HighlightEngine> getHighlightEngine() const;
+    void updateHighlightEngine();
+
+    // Snapshot of what the message builders need, replaced whenever the settings, the theme or
+    // the global emotes change. Safe to call from any thread.
+    std::shared_ptr<const messages::ParseContext> getParseContext() const;
+    void updateParseContext();
+
     void saveSnapshot();
     void recallSnapshot();
 
@@ -116,6 +132,13 @@ private:
     messages::MessageElement::Flags wordTypeMask = messages::MessageElement::Default;
 
     pajlada::Settings::SettingListener wordMaskListener;
+
+    std::shared_ptr<const messages::HighlightEngine> highlightEngine;
+    pajlada::Settings::Setting<std::string> currentUsername = {"/accounts/current", ""};
+    pajlada::Settings::SettingListener highlightListener;
+
+    std::shared_ptr<const messages::ParseContext> parseContext;
+    pajlada::Settings::SettingListener parseContextListener;
 };
 
 }  // namespace singletons
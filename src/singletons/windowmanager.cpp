@@ -42,6 +42,11 @@ void WindowManager::repaintGifEmotes()
     this->repaintGifs();
 }
 
+void WindowManager::showMessage(Channel *channel, const QString &messageId)
+{
+    this->scrollToMessage(channel, messageId);
+}
+
 // void WindowManager::updateAll()
 //{
 //    if (this->mainWindow != nullptr) {
@@ -18,6 +18,7 @@ public:
     void layoutVisibleChatWidgets(Channel *channel = nullptr);
     void repaintVisibleChatWidgets(Channel *channel = nullptr);
     void repaintGifEmotes();
+    void showMessage(Channel *channel, const QString &messageId);
     // void updateAll();
 
     widgets::Window &getMainWindow();
@@ -31,6 +32,7 @@ public:
 
     boost::signals2::signal<void()> repaintGifs;
     boost::signals2::signal<void(Channel *)> layout;
+    boost::signals2::signal<void(Channel *, const QString &)> scrollToMessage;
 
 private:
     ThemeManager &themeManager;
@@ -0,0 +1,95 @@
+#include "twitch/twitchbadgeresolver.hpp"
+
+#include <QHash>
+
+#include <cstring>
+
+namespace chatterino {
+namespace twitch {
+
+namespace {
+
+uint nextPowerOfTwo(uint value)
+{
+    uint result = 1;
+
+    while (result < value) {
+        result <<= 1;
+    }
+
+    return result;
+}
+
+uint hashBadge(const char *data, int size)
+{
+    return qHashBits(data, size_t(size));
+}
+
+}  // namespace
+
+TwitchBadgeResolver::TwitchBadgeResolver(const Badges &_badges,
+                                         const ResolvedBadge &_subscriberFallback)
+    : subscriberFallback(_subscriberFallback)
+{
+    // at most half full
+    this->slots.assign(nextPowerOfTwo(uint(_badges.size()) * 2 + 1), Slot{0, -1});
+    this->slotMask = uint(this->slots.size()) - 1;
+
+    this->keys.reserve(_badges.size());
+    this->badges.reserve(_badges.size());
+
+    for (const auto &badge : _badges) {
+        if (badge.second.image == nullptr) {
+            continue;
+        }
+
+        const QByteArray &key = badge.first;
+        uint hash = hashBadge(key.constData(), key.size());
+        uint i = hash & this->slotMask;
+        bool exists = false;
+
+        for (; this->slots[i].index != -1; i = (i + 1) & this->slotMask) {
+            if (this->slots[i].hash == hash && this->keys[this->slots[i].index] == key) {
+                exists = true;
+                break;
+            }
+        }
+
+        if (!exists) {
+            this->slots[i] = Slot{hash, int(this->badges.size())};
+            this->keys.push_back(key);
+            this->badges.push_back(badge.second);
+        }
+    }
+}
+
+const ResolvedBadge *TwitchBadgeResolver::resolve(const util::IrcTagValue &badge) const
+{
+    const char *data = badge.data();
+    int size = badge.size();
+    uint hash = hashBadge(data, size);
+
+    for (uint i = hash & this->slotMask;; i = (i + 1) & this->slotMask) {
+        const Slot &slot = this->slots[i];
+
+        if (slot.index == -1) {
+            break;
+        }
+
+        const QByteArray &key = this->keys[slot.index];
+
+        if (slot.hash == hash && key.size() == size &&
+            std::memcmp(key.constData(), data, size_t(size)) == 0) {
+            return &this->badges[slot.index];
+        }
+    }
+
+    if (this->subscriberFallback.image != nullptr && badge.startsWith("subscriber/")) {
+        return &this->subscriberFallback;
+    }
+
+    return nullptr;
+}
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "messages/image.hpp"
+#include "messages/messageelement.hpp"
+#include "util/irctags.hpp"
+#include "util/symbol.hpp"
+
+#include <QByteArray>
+
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+namespace twitch {
+
+struct ResolvedBadge {
+    messages::Image *image = nullptr;
+    messages::MessageElement::Flags flags = messages::MessageElement::None;
+
+    // empty if the badge has no tooltip
+    util::Symbol tooltip;
+};
+
+//
+// Maps the raw badges of a message ("subscriber/12") to what is shown for them
+//
+// - one resolver is built per room by the ResourceManager, from the hardcoded badges, the badges
+//   of the channel and the global badges, whenever the channel or global badges finished loading
+// - a badge is one hash and one probe in an open addressing table, without allocating
+// - the resolver is never modified after it was built, so it can be used from any thread
+//
+class TwitchBadgeResolver
+{
+public:
+    // the first badge with a key wins
+    typedef std::vector<std::pair<QByteArray, ResolvedBadge>> Badges;
+
+    // `subscriberFallback` is used for subscriber badges the channel has no image for, it's
+    // ignored if it has no image
+    explicit TwitchBadgeResolver(const Badges &badges,
+                                 const ResolvedBadge &subscriberFallback = ResolvedBadge());
+
+    // returns nullptr if the badge is unknown
+    const ResolvedBadge *resolve(const util::IrcTagValue &badge) const;
+
+private:
+    struct Slot {
+        uint hash;
+        int index;
+    };
+
+    std::vector<QByteArray> keys;
+    std::vector<ResolvedBadge> badges;
+
+    std::vector<Slot> slots;
+    uint slotMask = 0;
+
+    ResolvedBadge subscriberFallback;
+};
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -1,6 +1,7 @@
 #include "twitchchannel.hpp"
 #include "debug/log.hpp"
 #include "singletons/emotemanager.hpp"
+#include "singletons/settingsmanager.hpp"
 #include "twitch/twitchmessagebuilder.hpp"
 #include "util/urlfetch.hpp"
 
@@ -21,6 +22,19 @@ TwitchChannel::TwitchChannel(const QString &channelName)
 {
     debug::Log("[TwitchChannel:{}] Opened", this->name);
 
+    this->refreshEmoteTable();
+    this->emotesChangedConnection =
+        singletons::EmoteManager::getInstance().emotesChanged.connect([this] {
+            this->refreshEmoteTable();  //
+        });
+    this->channelEmotesChangedConnection =
+        singletons::EmoteManager::getInstance().channelEmotesChanged.connect(
+            [this](const QString &channelName) {
+                if (channelName == this->name) {
+                    this->refreshEmoteTable();
+                }
+            });
+
     this->reloadChannelEmotes();
 
     this->liveStatusTimer = new QTimer;
@@ -33,6 +47,10 @@ TwitchChannel::TwitchChannel(const QString &channelName)
         this->refreshLiveStatus();  //
     });
 
+    if (!this->isEmpty()) {
+        this->enableColdStorage();
+    }
+
     this->fetchMessages.connect([this] {
         this->fetchRecentMessages();  //
     });
@@ -71,6 +89,19 @@ void TwitchChannel::reloadChannelEmotes()
     emoteManager.reloadFFZChannelEmotes(this->name, this->ffzChannelEmotes);
 }
 
+std::shared_ptr<const util::EmoteTable> TwitchChannel::getEmoteTable() const
+{
+    return std::atomic_load(&this->emoteTable);
+}
+
+void TwitchChannel::refreshEmoteTable()
+{
+    auto table = singletons::EmoteManager::getInstance().buildEmoteTable(
+        this->bttvChannelEmotes.get(), this->ffzChannelEmotes.get());
+
+    std::atomic_store(&this->emoteTable, table);
+}
+
 void TwitchChannel::sendMessage(const QString &message)
 {
     auto &emoteManager = singletons::EmoteManager::getInstance();
@@ -83,6 +114,36 @@ void TwitchChannel::sendMessage(const QString &message)
     singletons::IrcManager::getInstance().sendMessage(this->name, parsedMessage);
 }
 
+messages::MessagePtr TwitchChannel::restoreMessage(const QByteArray &ircData)
+{
+    // restored messages are built like the recent messages, using the time they were sent at
+    // and without triggering highlights again
+    QByteArray historicalData = ircData.startsWith('@') ? "@historical=1;" + ircData.mid(1)
+                                                         : "@historical=1 " + ircData;
+
+    // runs on a parse thread, the connection lives on the gui thread
+    std::unique_ptr<Communi::IrcMessage> message(
+        Communi::IrcMessage::fromData(historicalData, nullptr));
+
+    if (!message || message->type() != Communi::IrcMessage::Private) {
+        return messages::MessagePtr();
+    }
+
+    message->setEncoding("UTF-8");
+
+    messages::MessageParseArgs args;
+    twitch::TwitchMessageBuilder builder(
+        this, static_cast<Communi::IrcPrivateMessage *>(message.get()), args,
+        singletons::SettingManager::getInstance().getParseContext());
+
+    return builder.parse();
+}
+
+void TwitchChannel::runInBackground(std::function<void()> task)
+{
+    singletons::IrcManager::getInstance().runOnParseThreads(std::move(task));
+}
+
 void TwitchChannel::setLive(bool newLiveStatus)
 {
     if (this->isLive == newLiveStatus) {
@@ -182,13 +243,15 @@ void TwitchChannel::fetchRecentMessages()
             std::vector<messages::MessagePtr> messages;
             messages.resize(msgArray.size());
 
+            auto context = singletons::SettingManager::getInstance().getParseContext();
+
             for (int i = 0; i < msgArray.size(); i++) {
                 QByteArray content = msgArray[i].toString().toUtf8();
                 auto msg = Communi::IrcMessage::fromData(content, readConnection);
                 auto privMsg = static_cast<Communi::IrcPrivateMessage *>(msg);
 
                 messages::MessageParseArgs args;
-                twitch::TwitchMessageBuilder builder(channel, privMsg, args);
+                twitch::TwitchMessageBuilder builder(channel, privMsg, args, context);
                 messages.at(i) = builder.parse();
             }
             channel->addMessagesAtStart(messages);
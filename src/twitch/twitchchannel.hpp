@@ -25,6 +25,10 @@ public:
     const std::shared_ptr<chatterino::util::EmoteMap> bttvChannelEmotes;
     const std::shared_ptr<chatterino::util::EmoteMap> ffzChannelEmotes;
 
+    // Global and channel emotes merged into one table, swapped out whenever either changes.
+    // Safe to call from any thread.
+    std::shared_ptr<const util::EmoteTable> getEmoteTable() const;
+
     const QString subscriptionURL;
     const QString channelURL;
     const QString popoutPlayerURL;
@@ -42,11 +46,21 @@ public:
     QString streamGame;
     QString streamUptime;
 
+protected:
+    messages::MessagePtr restoreMessage(const QByteArray &ircData) override;
+    void runInBackground(std::function<void()> task) override;
+
 private:
     void setLive(bool newLiveStatus);
     void refreshLiveStatus();
 
     void fetchRecentMessages();
+
+    void refreshEmoteTable();
+
+    std::shared_ptr<const util::EmoteTable> emoteTable;
+    boost::signals2::scoped_connection emotesChangedConnection;
+    boost::signals2::scoped_connection channelEmotesChangedConnection;
 };
 
 }  // namespace twitch
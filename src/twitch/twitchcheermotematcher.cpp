@@ -0,0 +1,186 @@
+#include "twitch/twitchcheermotematcher.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace chatterino {
+namespace twitch {
+
+namespace {
+
+ushort foldCase(QChar character)
+{
+    ushort unicode = character.unicode();
+
+    if (unicode < 128) {
+        return unicode >= 'A' && unicode <= 'Z' ? ushort(unicode + ('a' - 'A')) : unicode;
+    }
+
+    return character.toLower().unicode();
+}
+
+// [1-9][0-9]* that fits into an int
+bool parseAmount(const QChar *it, const QChar *end, int &amount)
+{
+    if (it == end || *it < '1' || *it > '9') {
+        return false;
+    }
+
+    qint64 value = 0;
+
+    for (; it != end; it++) {
+        if (*it < '0' || *it > '9') {
+            return false;
+        }
+
+        value = value * 10 + (it->unicode() - '0');
+
+        if (value > std::numeric_limits<int>::max()) {
+            return false;
+        }
+    }
+
+    amount = int(value);
+
+    return true;
+}
+
+}  // namespace
+
+TwitchCheermoteMatcher::TwitchCheermoteMatcher(const std::vector<CheermoteSet> &sets)
+    : nodes{Node{0, 0, -1}}
+{
+    std::vector<std::pair<QString, int>> prefixes;
+
+    for (const CheermoteSet &set : sets) {
+        if (set.prefix.isEmpty() || set.cheermotes.empty()) {
+            continue;
+        }
+
+        QString prefix;
+        prefix.reserve(set.prefix.size());
+
+        for (QChar character : set.prefix) {
+            prefix.append(QChar(foldCase(character)));
+        }
+
+        prefixes.emplace_back(prefix, int(this->tiers.size()));
+
+        this->tiers.push_back(set.cheermotes);
+
+        std::sort(this->tiers.back().begin(), this->tiers.back().end(),
+                  [](const Cheermote &lhs, const Cheermote &rhs) {
+                      return lhs.minBits < rhs.minBits;  //
+                  });
+    }
+
+    // stable, so duplicates stay in the order they were given in
+    std::stable_sort(prefixes.begin(), prefixes.end(),
+                     [](const std::pair<QString, int> &a, const std::pair<QString, int> &b) {
+                         return a.first < b.first;  //
+                     });
+
+    this->build(prefixes, 0, 0, int(prefixes.size()), 0);
+}
+
+bool TwitchCheermoteMatcher::match(const QString &word, Match &match) const
+{
+    const QChar *begin = word.constData();
+    const QChar *end = begin + word.size();
+    int node = 0;
+
+    // prefixes can end in digits themselves, so every prefix the word starts with is tried and
+    // the longest one with a valid amount wins
+    bool matched = false;
+
+    for (const QChar *it = begin; it != end; it++) {
+        const Node &current = this->nodes[node];
+
+        auto keysBegin = this->edgeKeys.begin() + current.firstEdge;
+        auto keysEnd = keysBegin + current.edgeCount;
+        ushort unit = foldCase(*it);
+        auto key = std::lower_bound(keysBegin, keysEnd, unit);
+
+        if (key == keysEnd || *key != unit) {
+            break;
+        }
+
+        node = this->edgeTargets[key - this->edgeKeys.begin()];
+
+        int set = this->nodes[node].set;
+        int bits;
+
+        if (set == -1 || !parseAmount(it + 1, end, bits)) {
+            continue;
+        }
+
+        const std::vector<Cheermote> &cheermotes = this->tiers[set];
+
+        // the last tier with minBits <= bits
+        auto tier = std::upper_bound(cheermotes.begin(), cheermotes.end(), bits,
+                                     [](int value, const Cheermote &cheermote) {
+                                         return value < cheermote.minBits;  //
+                                     });
+
+        if (tier == cheermotes.begin()) {
+            continue;
+        }
+
+        match.cheermote = &*(tier - 1);
+        match.amountStart = int(it + 1 - begin);
+        match.bits = bits;
+        matched = true;
+    }
+
+    return matched;
+}
+
+void TwitchCheermoteMatcher::build(const std::vector<std::pair<QString, int>> &prefixes,
+                                   int node, int first, int last, int depth)
+{
+    // all prefixes in [first, last) share their first `depth` code units, the ones that end here
+    // sort before the longer ones
+    if (first != last && prefixes[first].first.size() == depth) {
+        this->nodes[node].set = prefixes[first].second;
+
+        while (first != last && prefixes[first].first.size() == depth) {
+            first++;
+        }
+    }
+
+    // add the edges of this node first so they end up next to each other
+    this->nodes[node].firstEdge = int(this->edgeKeys.size());
+
+    for (int i = first; i != last; i++) {
+        ushort key = prefixes[i].first.at(depth).unicode();
+
+        if (i == first || key != this->edgeKeys.back()) {
+            this->edgeKeys.push_back(key);
+            this->edgeTargets.push_back(-1);
+        }
+    }
+
+    this->nodes[node].edgeCount = int(this->edgeKeys.size()) - this->nodes[node].firstEdge;
+
+    int edge = this->nodes[node].firstEdge;
+
+    for (int childFirst = first; childFirst != last; edge++) {
+        ushort key = this->edgeKeys[edge];
+        int childLast = childFirst;
+
+        while (childLast != last && prefixes[childLast].first.at(depth).unicode() == key) {
+            childLast++;
+        }
+
+        int child = int(this->nodes.size());
+        this->nodes.push_back(Node{0, 0, -1});
+        this->edgeTargets[edge] = child;
+
+        this->build(prefixes, child, childFirst, childLast, depth + 1);
+
+        childFirst = childLast;
+    }
+}
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "singletons/resourcemanager.hpp"
+
+#include <QString>
+
+#include <vector>
+
+namespace chatterino {
+namespace twitch {
+
+//
+// Matches the cheers of a room ("Cheer100", "kappa5000") against all of its cheermote prefixes
+//
+// - the prefixes are compiled into one trie, a word is walked once and compared case
+//   insensitively without copying it
+// - the tier is found with a binary search over the tiers sorted by their minimum bits
+// - built by the ResourceManager when the cheermotes of a channel are loaded and never modified
+//   afterwards, so it can be used from any thread
+//
+class TwitchCheermoteMatcher
+{
+public:
+    typedef singletons::ResourceManager::Cheermote Cheermote;
+    typedef singletons::ResourceManager::CheermoteSet CheermoteSet;
+
+    struct Match {
+        const Cheermote *cheermote = nullptr;
+
+        // where the amount of bits starts in the word, it takes the rest of the word
+        int amountStart = 0;
+        int bits = 0;
+    };
+
+    // if two sets have the same prefix the first one is kept
+    explicit TwitchCheermoteMatcher(const std::vector<CheermoteSet> &sets);
+
+    // The word has to be a prefix followed by an amount without leading zeros. Returns false if
+    // it isn't or the amount is below the lowest tier.
+    bool match(const QString &word, Match &match) const;
+
+private:
+    struct Node {
+        int firstEdge;
+        int edgeCount;
+
+        // index into `tiers`, -1 if no prefix ends here
+        int set;
+    };
+
+    void build(const std::vector<std::pair<QString, int>> &prefixes, int node, int first, int last,
+               int depth);
+
+    std::vector<Node> nodes;
+
+    // edges are split up so the binary search only touches the keys
+    std::vector<ushort> edgeKeys;
+    std::vector<int> edgeTargets;
+
+    // the cheermotes of each set, sorted by minBits
+    std::vector<std::vector<Cheermote>> tiers;
+};
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -0,0 +1,145 @@
+#include "twitch/twitchemotetag.hpp"
+
+namespace chatterino {
+namespace twitch {
+
+namespace {
+
+// reads a non-negative decimal number, fails if there are no digits or it doesn't fit in an int
+template <typename T>
+bool readNumber(const char *&it, const char *end, T &number)
+{
+    const char *begin = it;
+    number = 0;
+
+    while (it != end && *it >= '0' && *it <= '9') {
+        if (number > 100000000) {
+            return false;
+        }
+
+        number = number * 10 + (*it - '0');
+        it++;
+    }
+
+    return it != begin;
+}
+
+void insertSorted(TwitchEmoteRanges &ranges, const TwitchEmoteRange &range)
+{
+    // the ranges of one emote are sent in order, so this is almost always an append
+    auto position = ranges.end();
+
+    while (position != ranges.begin() && (position - 1)->start > range.start) {
+        position--;
+    }
+
+    ranges.insert(position, range);
+}
+
+void decode(const util::IrcTagValue &tag, TwitchEmoteRanges &ranges)
+{
+    const char *it = tag.data();
+    const char *end = it + tag.size();
+
+    while (it < end) {
+        long id;
+
+        if (readNumber(it, end, id) && it != end && *it == ':') {
+            it++;
+
+            while (true) {
+                TwitchEmoteRange range{id, 0, 0, 0, 0};
+
+                if (readNumber(it, end, range.start) && it != end && *it == '-' &&
+                    readNumber(++it, end, range.end) && range.start <= range.end) {
+                    insertSorted(ranges, range);
+                }
+
+                // skip whatever is left of a malformed range
+                while (it != end && *it != ',' && *it != '/') {
+                    it++;
+                }
+
+                if (it == end || *it == '/') {
+                    break;
+                }
+
+                it++;
+            }
+        }
+
+        // skip to the next emote
+        while (it != end && *it != '/') {
+            it++;
+        }
+
+        if (it != end) {
+            it++;
+        }
+    }
+}
+
+}  // namespace
+
+void parseTwitchEmoteTag(const util::IrcTagValue &tag, const QString &content,
+                         TwitchEmoteRanges &ranges)
+{
+    ranges.clear();
+
+    if (tag.isEmpty()) {
+        return;
+    }
+
+    decode(tag, ranges);
+
+    // the offsets in the tag count code points, walk the message once to find where the ranges
+    // are in the utf-16 string
+    const QChar *text = content.constData();
+    int size = content.size();
+
+    int codePoint = 0;
+    int index = 0;
+
+    auto advance = [&] {
+        if (text[index].isHighSurrogate() && index + 1 < size && text[index + 1].isLowSurrogate()) {
+            index += 2;
+        } else {
+            index++;
+        }
+
+        codePoint++;
+    };
+
+    auto output = ranges.begin();
+
+    for (auto range = ranges.begin(); range != ranges.end(); range++) {
+        // overlaps the previous range
+        if (range->start < codePoint) {
+            continue;
+        }
+
+        while (codePoint < range->start && index < size) {
+            advance();
+        }
+
+        range->utf16Start = index;
+
+        while (codePoint <= range->end && index < size) {
+            advance();
+        }
+
+        // the ranges are sorted, so all the following ones are out of bounds too
+        if (codePoint <= range->end) {
+            break;
+        }
+
+        range->utf16Length = index - range->utf16Start;
+
+        *output++ = *range;
+    }
+
+    ranges.erase(output, ranges.end());
+}
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "util/irctags.hpp"
+
+#include <QString>
+
+#include <boost/container/small_vector.hpp>
+
+namespace chatterino {
+namespace twitch {
+
+// Where a twitch emote is in the message
+struct TwitchEmoteRange {
+    long id;
+
+    // code point offsets as sent in the tag, `end` is inclusive
+    int start;
+    int end;
+
+    // position in the QString of the message
+    int utf16Start;
+    int utf16Length;
+};
+
+typedef boost::container::small_vector<TwitchEmoteRange, 16> TwitchEmoteRanges;
+
+// Decodes the "emotes" tag ("id:start-end,start-end/id:start-end") of a message in one pass.
+// The ranges are sorted by their start. Malformed, overlapping and out of bounds ranges are
+// skipped.
+void parseTwitchEmoteTag(const util::IrcTagValue &tag, const QString &content,
+                         TwitchEmoteRanges &ranges);
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -3,35 +3,73 @@
 #include "singletons/emotemanager.hpp"
 #include "singletons/ircmanager.hpp"
 #include "singletons/resourcemanager.hpp"
-#include "singletons/settingsmanager.hpp"
-#include "singletons/thememanager.hpp"
-#include "singletons/windowmanager.hpp"
+#include "twitch/twitchbadgeresolver.hpp"
 #include "twitch/twitchchannel.hpp"
+#include "twitch/twitchcheermotematcher.hpp"
 
-#include <QApplication>
 #include <QDebug>
-#include <QMediaPlayer>
+
+#include <algorithm>
 
 using namespace chatterino::messages;
 
 namespace chatterino {
 namespace twitch {
 
+namespace {
+
+// parses the "#RRGGBB" colors twitch sends without converting the tag to a string
+bool parseHexColor(const util::IrcTagValue &value, QColor &color)
+{
+    if (value.size() != 7 || value.data()[0] != '#') {
+        return false;
+    }
+
+    int rgb = 0;
+
+    for (int i = 1; i < 7; i++) {
+        char c = value.data()[i];
+        int digit;
+
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return false;
+        }
+
+        rgb = rgb * 16 + digit;
+    }
+
+    color = QColor((rgb >> 16) & 0xff, (rgb >> 8) & 0xff, rgb & 0xff);
+
+    return true;
+}
+
+}  // namespace
+
 TwitchMessageBuilder::TwitchMessageBuilder(Channel *_channel,
                                            const Communi::IrcPrivateMessage *_ircMessage,
-                                           const messages::MessageParseArgs &_args)
+                                           const messages::MessageParseArgs &_args,
+                                           std::shared_ptr<const ParseContext> _context)
     : channel(_channel)
     , twitchChannel(dynamic_cast<TwitchChannel *>(_channel))
     , ircMessage(_ircMessage)
     , args(_args)
-    , tags(this->ircMessage->tags())
-    , usernameColor(singletons::ThemeManager::getInstance().messages.textColors.system)
+    , context(std::move(_context))
+    , ircData(this->ircMessage->toData())
+    , tags(this->ircData)
+    , emoteTable(this->twitchChannel != nullptr ? this->twitchChannel->getEmoteTable()
+                                                : this->context->globalEmoteTable)
+    , usernameColor(this->context->systemTextColor)
 {
 }
 
 MessagePtr TwitchMessageBuilder::parse()
 {
-    singletons::SettingManager &settings = singletons::SettingManager::getInstance();
     singletons::EmoteManager &emoteManager = singletons::EmoteManager::getInstance();
 
     this->originalMessage = this->ircMessage->content();
@@ -48,10 +86,9 @@ MessagePtr TwitchMessageBuilder::parse()
 
     // Appends the correct timestamp if the message is a past message
 
-    bool isPastMsg = this->tags.contains("historical");
+    bool isPastMsg = this->tags.historical.isPresent();
     if (isPastMsg) {
-        // This may be architecture dependent(datatype)
-        qint64 ts = this->tags.value("tmi-sent-ts").toLongLong();
+        qint64 ts = this->tags.tmiSentTs.toLongLong();
         QDateTime dateTime = QDateTime::fromMSecsSinceEpoch(ts);
         this->append<TimestampElement>(dateTime.time());
     } else {
@@ -62,6 +99,12 @@ MessagePtr TwitchMessageBuilder::parse()
 
     this->parseRoomID();
 
+    this->message->setIrcData(this->ircData);
+
+    if (this->tags.tmiSentTs.isPresent()) {
+        this->message->setSentTimestamp(this->tags.tmiSentTs.toLongLong());
+    }
+
     // TIMESTAMP
     this->append<TwitchModerationElement>();
 
@@ -76,127 +119,111 @@ MessagePtr TwitchMessageBuilder::parse()
     this->appendUsername();
 
     // highlights
-    if (settings.enableHighlights && !isPastMsg) {
+    if (this->context->enableHighlights && !isPastMsg) {
         this->parseHighlights();
     }
 
-    QString bits;
-    auto iterator = this->tags.find("bits");
-    if (iterator != this->tags.end()) {
-        bits = iterator.value().toString();
+    if (!this->tags.bits.isEmpty()) {
+        this->cheermoteMatcher =
+            singletons::ResourceManager::getInstance().getCheermoteMatcher(this->roomID);
     }
 
-    // twitch emotes
-    std::vector<std::pair<long, util::EmoteData>> twitchEmotes;
-
-    iterator = this->tags.find("emotes");
-    if (iterator != this->tags.end()) {
-        QStringList emoteString = iterator.value().toString().split('/');
-
-        for (QString emote : emoteString) {
-            this->appendTwitchEmote(ircMessage, emote, twitchEmotes);
-        }
-
-        struct {
-            bool operator()(const std::pair<long, util::EmoteData> &lhs,
-                            const std::pair<long, util::EmoteData> &rhs)
-            {
-                return lhs.first < rhs.first;
-            }
-        } customLess;
-
-        std::sort(twitchEmotes.begin(), twitchEmotes.end(), customLess);
-    }
+    // twitch emotes, sorted by their position
+    TwitchEmoteRanges twitchEmotes;
+    parseTwitchEmoteTag(this->tags.emotes, this->originalMessage, twitchEmotes);
 
     auto currentTwitchEmote = twitchEmotes.begin();
 
-    // words
-
-    QStringList splits = this->originalMessage.split(' ');
+    // words, split and classified in one pass
+    util::MessageTokens tokens;
+    util::tokenizeMessage(this->originalMessage, tokens);
 
-    long int i = 0;
-
-    for (QString split : splits) {
-        MessageColor textColor = ircMessage->isAction() ? MessageColor(this->usernameColor)
-                                                        : MessageColor(MessageColor::Text);
+    for (const util::MessageToken &token : tokens) {
+        // skip emotes that don't start at a word
+        while (currentTwitchEmote != twitchEmotes.end() &&
+               currentTwitchEmote->start < token.codePointStart) {
+            currentTwitchEmote++;
+        }
 
         // twitch emote
-        if (currentTwitchEmote != twitchEmotes.end() && currentTwitchEmote->first == i) {
-            auto emoteImage = currentTwitchEmote->second;
+        if (currentTwitchEmote != twitchEmotes.end() &&
+            currentTwitchEmote->start == token.codePointStart) {
+            auto emoteImage = emoteManager.getTwitchEmoteById(
+                currentTwitchEmote->id,
+                this->originalMessage.midRef(currentTwitchEmote->utf16Start,
+                                             currentTwitchEmote->utf16Length));
             this->append<EmoteElement>(emoteImage, MessageElement::TwitchEmote);
 
-            i += split.length() + 1;
             currentTwitchEmote = std::next(currentTwitchEmote);
 
             continue;
         }
 
+        QString word = this->originalMessage.mid(token.start, token.length);
+
+        if (!token.is(util::MessageToken::EmojiCandidate)) {
+            this->appendWord(word, token.is(util::MessageToken::UrlCandidate));
+            continue;
+        }
+
         // split words
         std::vector<std::tuple<util::EmoteData, QString>> parsed;
 
         // Parse emojis and take all non-emojis and put them in parsed as full text-words
-        emoteManager.parseEmojis(parsed, split);
+        emoteManager.parseEmojis(parsed, word);
 
         for (const auto &tuple : parsed) {
             const util::EmoteData &emoteData = std::get<0>(tuple);
 
             if (!emoteData.isValid()) {  // is text
-                QString string = std::get<1>(tuple);
-
-                if (!bits.isEmpty() && this->tryParseCheermote(string)) {
-                    // This string was parsed as a cheermote
-                    continue;
-                }
-
-                // TODO: Implement ignored emotes
-                // Format of ignored emotes:
-                // Emote name: "forsenPuke" - if string in ignoredEmotes
-                // Will match emote regardless of source (i.e. bttv, ffz)
-                // Emote source + name: "bttv:nyanPls"
-                if (this->tryAppendEmote(string)) {
-                    // Successfully appended an emote
-                    continue;
-                }
-
-                // Actually just text
-                QString linkString = this->matchLink(string);
-
-                Link link;
-
-                if (linkString.isEmpty()) {
-                    link = Link();
-                } else {
-                    link = Link(Link::Url, linkString);
-                    textColor = MessageColor(MessageColor::Link);
-                }
-
-                this->append<TextElement>(string, EmoteElement::Text)  //
-                    ->setLink(link);
+                this->appendWord(std::get<1>(tuple), token.is(util::MessageToken::UrlCandidate));
             } else {  // is emoji
                 this->append<EmoteElement>(emoteData, EmoteElement::EmojiAll);
             }
         }
+    }
 
-        for (int j = 0; j < split.size(); j++) {
-            i++;
+    return this->getMessage();
+}
 
-            if (split.at(j).isHighSurrogate()) {
-                j++;
-            }
-        }
+void TwitchMessageBuilder::appendWord(const QString &word, bool maybeLink)
+{
+    if (this->cheermoteMatcher != nullptr && this->tryParseCheermote(word)) {
+        // This string was parsed as a cheermote
+        return;
+    }
 
-        i++;
+    // TODO: Implement ignored emotes
+    // Format of ignored emotes:
+    // Emote name: "forsenPuke" - if string in ignoredEmotes
+    // Will match emote regardless of source (i.e. bttv, ffz)
+    // Emote source + name: "bttv:nyanPls"
+    if (this->tryAppendEmote(word)) {
+        // Successfully appended an emote
+        return;
     }
 
-    return this->getMessage();
+    // Actually just text, only words the tokenizer marked as url candidates can be links
+    Link link;
+
+    if (maybeLink) {
+        QString linkString = this->matchLink(word);
+
+        if (!linkString.isEmpty()) {
+            link = Link(Link::Url, linkString);
+        }
+    }
+
+    // the word was split by the tokenizer already
+    this->append<TextElement>(TextElement::Words{word}, EmoteElement::Text)  //
+        ->setLink(link);
 }
 
 void TwitchMessageBuilder::parseMessageID()
 {
-    auto iterator = this->tags.find("id");
-
-    if (iterator != this->tags.end()) {
-        this->messageID = iterator.value().toString();
+    if (this->tags.id.isPresent()) {
+        this->messageID = this->tags.id.toString();
+        this->message->setId(this->messageID);
     }
 }
 
@@ -206,21 +233,15 @@ void TwitchMessageBuilder::parseRoomID()
         return;
     }
 
-    auto iterator = this->tags.find("room-id");
-
-    if (iterator != std::end(this->tags)) {
-        this->roomID = iterator.value().toString();
-
-        if (this->twitchChannel->roomID.isEmpty()) {
-            this->twitchChannel->roomID = this->roomID;
-        }
+    if (this->tags.roomId.isPresent()) {
+        this->roomID = this->tags.roomId.toString();
     }
 }
 
 void TwitchMessageBuilder::parseChannelName()
 {
     QString channelName("#" + this->channel->name);
-    Link link(Link::Url, this->channel->name + "\n" + this->messageID);
+    Link link(Link::ShowMessage, this->channel->name + "\n" + this->messageID);
 
     this->append<TextElement>(channelName, MessageElement::ChannelName, MessageColor::System)  //
         ->setLink(link);
@@ -228,19 +249,18 @@ void TwitchMessageBuilder::parseChannelName()
 
 void TwitchMessageBuilder::parseUsername()
 {
-    auto iterator = this->tags.find("color");
-    if (iterator != this->tags.end()) {
-        this->usernameColor = QColor(iterator.value().toString());
+    if (!this->tags.color.isEmpty() && !parseHexColor(this->tags.color, this->usernameColor)) {
+        this->usernameColor = QColor(this->tags.color.toString());
     }
 
     // username
     this->userName = ircMessage->nick();
 
     if (this->userName.isEmpty()) {
-        this->userName = this->tags.value(QLatin1String("login")).toString();
+        this->userName = this->tags.login.toString();
     }
 
-    this->message->loginName = this->userName;
+    this->message->loginName = util::Symbol(this->userName);
 }
 
 void TwitchMessageBuilder::appendUsername()
@@ -248,19 +268,18 @@ void TwitchMessageBuilder::appendUsername()
     QString username = this->userName;
     QString localizedName;
 
-    auto iterator = this->tags.find("display-name");
-    if (iterator != this->tags.end()) {
-        QString displayName = iterator.value().toString();
+    if (this->tags.displayName.isPresent()) {
+        QString displayName = this->tags.displayName.toString();
 
         if (QString::compare(displayName, this->userName, Qt::CaseInsensitive) == 0) {
             username = displayName;
 
-            this->message->displayName = displayName;
+            this->message->displayName = util::Symbol(displayName);
         } else {
             localizedName = displayName;
 
-            this->message->displayName = username;
-            this->message->localizedName = displayName;
+            this->message->displayName = util::Symbol(username);
+            this->message->localizedName = util::Symbol(displayName);
         }
     }
 
@@ -269,10 +288,7 @@ void TwitchMessageBuilder::appendUsername()
     // The full string that will be rendered in the chat widget
     QString usernameText;
 
-    pajlada::Settings::Setting<int> usernameDisplayMode(
-        "/appearance/messages/usernameDisplayMode", UsernameDisplayMode::UsernameAndLocalizedName);
-
-    switch (usernameDisplayMode.getValue()) {
+    switch (this->context->usernameDisplayMode) {
         case UsernameDisplayMode::Username: {
             usernameText = username;
         } break;
@@ -316,164 +332,44 @@ void TwitchMessageBuilder::appendUsername()
 
 void TwitchMessageBuilder::parseHighlights()
 {
-    static auto player = new QMediaPlayer;
-    static QUrl currentPlayerUrl;
-    singletons::SettingManager &settings = singletons::SettingManager::getInstance();
-    static pajlada::Settings::Setting<std::string> currentUser("/accounts/current");
-
-    QString currentUsername = QString::fromStdString(currentUser.getValue());
-
-    if (this->ircMessage->nick() == currentUsername) {
+    if (this->ircMessage->nick() == this->context->currentUsername) {
         // Do nothing. Highlights cannot be triggered by yourself
         return;
     }
 
-    // update the media player url if necessary
-    QUrl highlightSoundUrl;
-    if (settings.customHighlightSound) {
-        highlightSoundUrl = QUrl(settings.pathHighlightSound.getValue());
-    } else {
-        highlightSoundUrl = QUrl("qrc:/sounds/ping2.wav");
-    }
-
-    if (currentPlayerUrl != highlightSoundUrl) {
-        player->setMedia(highlightSoundUrl);
-
-        currentPlayerUrl = highlightSoundUrl;
-    }
-
-    QStringList blackList =
-        settings.highlightUserBlacklist.getValue().split("\n", QString::SkipEmptyParts);
-
-    // TODO: This vector should only be rebuilt upon highlights being changed
-    auto activeHighlights = settings.highlightProperties.getValue();
-
-    if (settings.enableHighlightsSelf && currentUsername.size() > 0) {
-        messages::HighlightPhrase selfHighlight;
-        selfHighlight.key = currentUsername;
-        selfHighlight.sound = settings.enableHighlightSound;
-        selfHighlight.alert = settings.enableHighlightTaskbar;
-        activeHighlights.emplace_back(std::move(selfHighlight));
-    }
-
-    bool doHighlight = false;
-    bool playSound = false;
-    bool doAlert = false;
-
-    bool hasFocus = (QApplication::focusWidget() != nullptr);
-
-    if (!blackList.contains(this->ircMessage->nick(), Qt::CaseInsensitive)) {
-        for (const messages::HighlightPhrase &highlight : activeHighlights) {
-            if (this->originalMessage.contains(highlight.key, Qt::CaseInsensitive)) {
-                debug::Log("Highlight because {} contains {}", this->originalMessage,
-                           highlight.key);
-                doHighlight = true;
+    // compiled by the settings manager, includes the phrase for your own name
+    const auto &engine = this->context->highlightEngine;
 
-                if (highlight.sound) {
-                    playSound = true;
-                }
+    if (!engine->isBlacklisted(this->ircMessage->nick())) {
+        messages::HighlightEngine::Result result = engine->match(this->originalMessage);
 
-                if (highlight.alert) {
-                    doAlert = true;
-                }
-
-                if (playSound && doAlert) {
-                    // Break if no further action can be taken from other highlights
-                    // This might change if highlights can have custom colors/sounds/actions
-                    break;
-                }
-            }
+        for (int phrase : result.phrases) {
+            debug::Log("Highlight because {} contains {}", this->originalMessage,
+                       engine->getPhrases()[phrase].key);
         }
 
-        this->setHighlight(doHighlight);
-
-        if (playSound && (!hasFocus || settings.highlightAlwaysPlaySound)) {
-            player->play();
-        }
+        this->setHighlight(result.highlighted);
 
-        if (doAlert) {
-            QApplication::alert(singletons::WindowManager::getInstance().getMainWindow().window(),
-                                2500);
-        }
+        // the sound and the alert are triggered on the gui thread once the message is added
+        this->highlightSound = result.sound;
+        this->highlightAlert = result.alert;
 
-        if (doHighlight) {
+        if (result.highlighted) {
             this->message->addFlags(Message::Highlighted);
         }
     }
 }
 
-void TwitchMessageBuilder::appendTwitchEmote(const Communi::IrcPrivateMessage *ircMessage,
-                                             const QString &emote,
-                                             std::vector<std::pair<long int, util::EmoteData>> &vec)
+bool TwitchMessageBuilder::tryAppendEmote(const QString &emoteString)
 {
-    singletons::EmoteManager &emoteManager = singletons::EmoteManager::getInstance();
-    if (!emote.contains(':')) {
-        return;
-    }
-
-    QStringList parameters = emote.split(':');
+    const util::EmoteTable::Emote *emote = this->emoteTable->find(emoteString);
 
-    if (parameters.length() < 2) {
-        return;
+    if (emote == nullptr) {
+        return false;
     }
 
-    long int id = std::stol(parameters.at(0).toStdString(), nullptr, 10);
-
-    QStringList occurences = parameters.at(1).split(',');
-
-    for (QString occurence : occurences) {
-        QStringList coords = occurence.split('-');
-
-        if (coords.length() < 2) {
-            return;
-        }
-
-        long int start = std::stol(coords.at(0).toStdString(), nullptr, 10);
-        long int end = std::stol(coords.at(1).toStdString(), nullptr, 10);
-
-        if (start >= end || start < 0 || end > ircMessage->content().length()) {
-            return;
-        }
-
-        QString name = ircMessage->content().mid(start, end - start + 1);
-
-        vec.push_back(
-            std::pair<long int, util::EmoteData>(start, emoteManager.getTwitchEmoteById(id, name)));
-    }
-}
-
-bool TwitchMessageBuilder::tryAppendEmote(QString &emoteString)
-{
-    singletons::EmoteManager &emoteManager = singletons::EmoteManager::getInstance();
-    util::EmoteData emoteData;
-
-    if (emoteManager.bttvGlobalEmotes.tryGet(emoteString, emoteData)) {
-        // BTTV Global Emote
-        return this->appendEmote(emoteData);
-    } else if (this->twitchChannel != nullptr &&
-               this->twitchChannel->bttvChannelEmotes->tryGet(emoteString, emoteData)) {
-        // BTTV Channel Emote
-        return this->appendEmote(emoteData);
-    } else if (emoteManager.ffzGlobalEmotes.tryGet(emoteString, emoteData)) {
-        // FFZ Global Emote
-        return this->appendEmote(emoteData);
-    } else if (this->twitchChannel != nullptr &&
-               this->twitchChannel->ffzChannelEmotes->tryGet(emoteString, emoteData)) {
-        // FFZ Channel Emote
-        return this->appendEmote(emoteData);
-    } else if (emoteManager.getChatterinoEmotes().tryGet(emoteString, emoteData)) {
-        // Chatterino Emote
-        return this->appendEmote(emoteData);
-    }
-
-    return false;
-}
-
-bool TwitchMessageBuilder::appendEmote(const util::EmoteData &emoteData)
-{
-    this->append<EmoteElement>(emoteData, MessageElement::BttvEmote);
-
     // Perhaps check for ignored emotes here?
+    this->append<EmoteElement>(emote->data, emote->flags);
     return true;
 }
 
@@ -481,164 +377,47 @@ bool TwitchMessageBuilder::appendEmote(const util::EmoteData &emoteData)
 //		   maybe put the individual badges into a map instead of this mess
 void TwitchMessageBuilder::parseTwitchBadges()
 {
-    singletons::ResourceManager &resourceManager = singletons::ResourceManager::getInstance();
-    const auto &channelResources = resourceManager.channels[this->roomID];
-
-    auto iterator = this->tags.find("badges");
-
-    if (iterator == this->tags.end()) {
+    if (this->tags.badges.isEmpty()) {
         // No badges in this message
         return;
     }
 
-    QStringList badges = iterator.value().toString().split(',');
+    auto resolver = singletons::ResourceManager::getInstance().getBadgeResolver(this->roomID);
 
-    for (QString badge : badges) {
-        if (badge.isEmpty()) {
-            continue;
-        }
+    const char *it = this->tags.badges.data();
+    const char *end = it + this->tags.badges.size();
 
-        if (badge.startsWith("bits/")) {
-            if (!singletons::ResourceManager::getInstance().dynamicBadgesLoaded) {
-                // Do nothing
-                continue;
-            }
+    for (const char *badgeEnd = it; it < end; it = badgeEnd + 1) {
+        badgeEnd = std::find(it, end, ',');
 
-            QString cheerAmountQS = badge.mid(5);
-            std::string versionKey = cheerAmountQS.toStdString();
+        util::IrcTagValue badge(it, int(badgeEnd - it));
 
-            // Try to fetch channel-specific bit badge
-            try {
-                const auto &badge = channelResources.badgeSets.at("bits").versions.at(versionKey);
-                this->append<ImageElement>(*(badge.badgeImage1x), MessageElement::BadgeVanity);
-                continue;
-            } catch (const std::out_of_range &) {
-                // Channel does not contain a special bit badge for this version
-            }
-
-            // Use default bit badge
-            try {
-                const auto &badge = resourceManager.badgeSets.at("bits").versions.at(versionKey);
-                this->append<ImageElement>(*(badge.badgeImage1x), MessageElement::BadgeVanity);
-            } catch (const std::out_of_range &) {
-                debug::Log("No default bit badge for version {} found", versionKey);
-                continue;
-            }
-        } else if (badge == "staff/1") {
-            this->append<ImageElement>(*resourceManager.badgeStaff,
-                                       MessageElement::BadgeGlobalAuthority)
-                ->setTooltip("Twitch Staff");
-        } else if (badge == "admin/1") {
-            this->append<ImageElement>(*resourceManager.badgeAdmin,
-                                       MessageElement::BadgeGlobalAuthority)
-                ->setTooltip("Twitch Admin");
-        } else if (badge == "global_mod/1") {
-            this->append<ImageElement>(*resourceManager.badgeGlobalModerator,
-                                       MessageElement::BadgeGlobalAuthority)
-                ->setTooltip("Twitch Global Moderator");
-        } else if (badge == "moderator/1") {
-            // TODO: Implement custom FFZ moderator badge
-            this->append<ImageElement>(*resourceManager.badgeModerator,
-                                       MessageElement::BadgeChannelAuthority)
-                ->setTooltip("Twitch Channel Moderator");
-        } else if (badge == "turbo/1") {
-            this->append<ImageElement>(*resourceManager.badgeTurbo,
-                                       MessageElement::BadgeGlobalAuthority)
-                ->setTooltip("Twitch Turbo Subscriber");
-        } else if (badge == "broadcaster/1") {
-            this->append<ImageElement>(*resourceManager.badgeBroadcaster,
-                                       MessageElement::BadgeChannelAuthority)
-                ->setTooltip("Twitch Broadcaster");
-        } else if (badge == "premium/1") {
-            this->append<ImageElement>(*resourceManager.badgePremium, MessageElement::BadgeVanity)
-                ->setTooltip("Twitch Prime Subscriber");
-        } else if (badge.startsWith("partner/")) {
-            int index = badge.midRef(8).toInt();
-            switch (index) {
-                case 1: {
-                    this->append<ImageElement>(*resourceManager.badgeVerified,
-                                               MessageElement::BadgeVanity)
-                        ->setTooltip("Twitch Verified");
-                } break;
-                default: {
-                    printf("[TwitchMessageBuilder] Unhandled partner badge index: %d\n", index);
-                } break;
-            }
-        } else if (badge.startsWith("subscriber/")) {
-            if (channelResources.loaded == false) {
-                qDebug() << "Channel resources are not loaded, can't add the subscriber badge";
-                continue;
-            }
-
-            auto badgeSetIt = channelResources.badgeSets.find("subscriber");
-            if (badgeSetIt == channelResources.badgeSets.end()) {
-                // Fall back to default badge
-                this->append<ImageElement>(*resourceManager.badgeSubscriber,
-                                           MessageElement::BadgeSubscription)
-                    ->setTooltip("Twitch Subscriber");
-                continue;
-            }
-
-            const auto &badgeSet = badgeSetIt->second;
-
-            std::string versionKey = badge.mid(11).toStdString();
-
-            auto badgeVersionIt = badgeSet.versions.find(versionKey);
-
-            if (badgeVersionIt == badgeSet.versions.end()) {
-                // Fall back to default badge
-                this->append<ImageElement>(*resourceManager.badgeSubscriber,
-                                           MessageElement::BadgeSubscription)
-                    ->setTooltip("Twitch Subscriber");
-                continue;
-            }
-
-            auto &badgeVersion = badgeVersionIt->second;
-
-            this->append<ImageElement>(*badgeVersion.badgeImage1x,
-                                       MessageElement::BadgeSubscription)
-                ->setTooltip("Twitch " + QString::fromStdString(badgeVersion.title));
-        } else {
-            if (!resourceManager.dynamicBadgesLoaded) {
-                // Do nothing
-                continue;
-            }
-
-            QStringList parts = badge.split('/');
-
-            if (parts.length() != 2) {
-                qDebug() << "Bad number of parts: " << parts.length() << " in " << parts;
-                continue;
-            }
-
-            MessageElement::Flags badgeType = MessageElement::Flags::BadgeVanity;
+        if (badge.isEmpty()) {
+            continue;
+        }
 
-            std::string badgeSetKey = parts[0].toStdString();
-            std::string versionKey = parts[1].toStdString();
+        const twitch::ResolvedBadge *resolved = resolver->resolve(badge);
 
-            try {
-                auto &badgeSet = resourceManager.badgeSets.at(badgeSetKey);
+        if (resolved == nullptr) {
+            // unknown badge, or the badges of the channel aren't loaded yet
+            continue;
+        }
 
-                try {
-                    auto &badgeVersion = badgeSet.versions.at(versionKey);
+        auto element = this->append<ImageElement>(*resolved->image, resolved->flags);
 
-                    this->append<ImageElement>(*badgeVersion.badgeImage1x, badgeType)
-                        ->setTooltip("Twitch " + QString::fromStdString(badgeVersion.title));
-                } catch (const std::exception &e) {
-                    qDebug() << "Exception caught:" << e.what()
-                             << "when trying to fetch badge version " << versionKey.c_str();
-                }
-            } catch (const std::exception &e) {
-                qDebug() << "No badge set with key" << badgeSetKey.c_str()
-                         << ". Exception: " << e.what();
-            }
+        if (!resolved->tooltip.isEmpty()) {
+            element->setTooltip(resolved->tooltip);
         }
     }
 }
 
 void TwitchMessageBuilder::addChatterinoBadges()
 {
-    auto &badges = singletons::ResourceManager::getInstance().chatterinoBadges;
+    singletons::ResourceManager &resourceManager = singletons::ResourceManager::getInstance();
+
+    std::lock_guard<std::mutex> lock(resourceManager.mutex);
+
+    auto &badges = resourceManager.chatterinoBadges;
     auto it = badges.find(this->userName.toStdString());
 
     if (it == badges.end()) {
@@ -653,51 +432,19 @@ void TwitchMessageBuilder::addChatterinoBadges()
 
 bool TwitchMessageBuilder::tryParseCheermote(const QString &string)
 {
-    // Try to parse custom cheermotes
-    const auto &channelResources =
-        singletons::ResourceManager::getInstance().channels[this->roomID];
-    if (channelResources.loaded) {
-        for (const auto &cheermoteSet : channelResources.cheermoteSets) {
-            auto match = cheermoteSet.regex.match(string);
-            if (!match.hasMatch()) {
-                continue;
-            }
-            QString amount = match.captured(1);
-            bool ok = false;
-            int numBits = amount.toInt(&ok);
-            if (!ok) {
-                debug::Log("Error parsing bit amount in tryParseCheermote");
-                return false;
-            }
+    TwitchCheermoteMatcher::Match match;
 
-            auto savedIt = cheermoteSet.cheermotes.end();
-
-            // Fetch cheermote that matches our numBits
-            for (auto it = cheermoteSet.cheermotes.begin(); it != cheermoteSet.cheermotes.end();
-                 ++it) {
-                if (numBits >= it->minBits) {
-                    savedIt = it;
-                } else {
-                    break;
-                }
-            }
-
-            if (savedIt == cheermoteSet.cheermotes.end()) {
-                debug::Log("Error getting a cheermote from a cheermote set for the bit amount {}",
-                           numBits);
-                return false;
-            }
-
-            const auto &cheermote = *savedIt;
+    if (!this->cheermoteMatcher->match(string, match)) {
+        return false;
+    }
 
-            this->append<EmoteElement>(cheermote.emoteDataAnimated, EmoteElement::BitsAnimated);
-            this->append<TextElement>(amount, EmoteElement::Text, cheermote.color);
+    const auto &cheermote = *match.cheermote;
 
-            return true;
-        }
-    }
+    this->append<EmoteElement>(cheermote.emoteDataAnimated, EmoteElement::BitsAnimated);
+    this->append<TextElement>(TextElement::Words{string.mid(match.amountStart)},
+                              EmoteElement::Text, cheermote.color);
 
-    return false;
+    return true;
 }
 
 // bool
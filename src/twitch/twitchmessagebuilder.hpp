@@ -2,7 +2,11 @@
 
 #include "messages/messagebuilder.hpp"
 #include "messages/messageparseargs.hpp"
+#include "messages/parsecontext.hpp"
 #include "singletons/emotemanager.hpp"
+#include "twitch/twitchemotetag.hpp"
+#include "util/irctags.hpp"
+#include "util/messagetokenizer.hpp"
 
 #include <IrcMessage>
 
@@ -14,6 +18,7 @@ class Channel;
 
 namespace twitch {
 class TwitchChannel;
+class TwitchCheermoteMatcher;
 
 class TwitchMessageBuilder : public messages::MessageBuilder
 {
@@ -26,18 +31,29 @@ public:
 
     TwitchMessageBuilder() = delete;
 
+    // the context is usually SettingManager::getParseContext(), taken when the message arrived
     explicit TwitchMessageBuilder(Channel *_channel, const Communi::IrcPrivateMessage *_ircMessage,
-                                  const messages::MessageParseArgs &_args);
+                                  const messages::MessageParseArgs &_args,
+                                  std::shared_ptr<const messages::ParseContext> _context);
 
     Channel *channel;
     TwitchChannel *twitchChannel;
     const Communi::IrcPrivateMessage *ircMessage;
     messages::MessageParseArgs args;
-    const QVariantMap tags;
+    const std::shared_ptr<const messages::ParseContext> context;
+
+    // the tags point into the raw line
+    const QByteArray ircData;
+    const util::IrcTags tags;
 
     QString messageID;
     QString userName;
 
+    // Set by parse(), the builder can run on any thread so playing the highlight sound and
+    // alerting the window is left to the caller
+    bool highlightSound = false;
+    bool highlightAlert = false;
+
     messages::MessagePtr parse();
 
     //    static bool sortTwitchEmotes(
@@ -47,6 +63,12 @@ public:
 private:
     QString roomID;
 
+    // taken once so the whole message sees the same emotes
+    const std::shared_ptr<const util::EmoteTable> emoteTable;
+
+    // only taken for messages with bits, null otherwise
+    std::shared_ptr<const TwitchCheermoteMatcher> cheermoteMatcher;
+
     QColor usernameColor;
 
     void parseMessageID();
@@ -56,10 +78,8 @@ private:
     void appendUsername();
     void parseHighlights();
 
-    void appendTwitchEmote(const Communi::IrcPrivateMessage *ircMessage, const QString &emote,
-                           std::vector<std::pair<long, util::EmoteData>> &vec);
-    bool tryAppendEmote(QString &emoteString);
-    bool appendEmote(const util::EmoteData &emoteData);
+    bool tryAppendEmote(const QString &emoteString);
+    void appendWord(const QString &word, bool maybeLink);
 
     void parseTwitchBadges();
     void addChatterinoBadges();
@@ -0,0 +1,225 @@
+#include "twitch/twitchparsepipeline.hpp"
+#include "asyncexec.hpp"
+#include "channel.hpp"
+#include "singletons/settingsmanager.hpp"
+#include "singletons/windowmanager.hpp"
+#include "twitch/twitchmessagebuilder.hpp"
+
+#include <IrcMessage>
+#include <QApplication>
+#include <QMediaPlayer>
+
+#include <vector>
+
+using namespace chatterino::messages;
+
+namespace chatterino {
+namespace twitch {
+
+namespace {
+
+void triggerHighlight(bool playSound, bool doAlert)
+{
+    static auto player = new QMediaPlayer;
+    static QUrl currentPlayerUrl;
+
+    singletons::SettingManager &settings = singletons::SettingManager::getInstance();
+
+    if (playSound) {
+        // update the media player url if necessary
+        QUrl highlightSoundUrl;
+        if (settings.customHighlightSound) {
+            highlightSoundUrl = QUrl(settings.pathHighlightSound.getValue());
+        } else {
+            highlightSoundUrl = QUrl("qrc:/sounds/ping2.wav");
+        }
+
+        if (currentPlayerUrl != highlightSoundUrl) {
+            player->setMedia(highlightSoundUrl);
+
+            currentPlayerUrl = highlightSoundUrl;
+        }
+
+        bool hasFocus = (QApplication::focusWidget() != nullptr);
+
+        if (!hasFocus || settings.highlightAlwaysPlaySound) {
+            player->play();
+        }
+    }
+
+    if (doAlert) {
+        QApplication::alert(singletons::WindowManager::getInstance().getMainWindow().window(),
+                            2500);
+    }
+}
+
+}  // namespace
+
+TwitchParsePipeline::TwitchParsePipeline()
+{
+}
+
+TwitchParsePipeline::~TwitchParsePipeline()
+{
+    this->threadPool.clear();
+    this->threadPool.waitForDone();
+}
+
+void TwitchParsePipeline::push(const std::shared_ptr<Channel> &channel, const QByteArray &ircData,
+                               const MessageParseArgs &args)
+{
+    // owned by the queue of the channel, which only drops it on the gui thread after it's done
+    Job *job = new Job;
+    job->channel = channel;
+    job->ircData = ircData;
+    job->args = args;
+
+    // taken now so the message is parsed with the settings it arrived with
+    job->context = singletons::SettingManager::getInstance().getParseContext();
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->queues[channel].emplace_back(job);
+    }
+
+    this->threadPool.start(new LambdaRunnable([this, job] {
+        this->parse(*job);
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        // the job may be deleted as soon as it's done, it isn't touched after this
+        job->done = true;
+
+        if (!this->deliveryQueued) {
+            this->deliveryQueued = true;
+
+            postToThread([this] {
+                this->deliver();  //
+            });
+        }
+    }));
+}
+
+void TwitchParsePipeline::pushEvent(const std::shared_ptr<Channel> &channel,
+                                    std::function<void()> callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        auto it = this->queues.find(channel);
+
+        // delivered when the messages in front of it are done
+        if (it != this->queues.end() && !it->second.empty()) {
+            std::unique_ptr<Job> job(new Job);
+            job->channel = channel;
+            job->callback = std::move(callback);
+            job->done = true;
+
+            it->second.push_back(std::move(job));
+
+            return;
+        }
+    }
+
+    callback();
+}
+
+void TwitchParsePipeline::runTask(std::function<void()> task)
+{
+    this->threadPool.start(new LambdaRunnable(std::move(task)));
+}
+
+void TwitchParsePipeline::parse(Job &job)
+{
+    // the message is created without a connection since the connection lives on the gui thread
+    std::unique_ptr<Communi::IrcMessage> ircMessage(
+        Communi::IrcMessage::fromData(job.ircData, nullptr));
+
+    if (!ircMessage || ircMessage->type() != Communi::IrcMessage::Private) {
+        return;
+    }
+
+    ircMessage->setEncoding("UTF-8");
+
+    TwitchMessageBuilder builder(job.channel.get(),
+                                 static_cast<Communi::IrcPrivateMessage *>(ircMessage.get()),
+                                 job.args, job.context);
+
+    job.message = builder.parse();
+    job.highlightSound = builder.highlightSound;
+    job.highlightAlert = builder.highlightAlert;
+}
+
+void TwitchParsePipeline::deliver()
+{
+    // messages of one channel that are added together, or an event that runs after them
+    struct Step {
+        std::shared_ptr<Channel> channel;
+        std::vector<MessagePtr> messages;
+        std::function<void()> callback;
+    };
+
+    std::vector<Step> steps;
+    std::vector<std::unique_ptr<Job>> finishedJobs;
+    bool playSound = false;
+    bool doAlert = false;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->deliveryQueued = false;
+
+        for (auto it = this->queues.begin(); it != this->queues.end();) {
+            auto &queue = it->second;
+            std::vector<MessagePtr> messages;
+
+            // stop at the first message that is still being parsed to keep the order
+            while (!queue.empty() && queue.front()->done) {
+                std::unique_ptr<Job> job = std::move(queue.front());
+                queue.pop_front();
+
+                if (job->callback) {
+                    if (!messages.empty()) {
+                        steps.push_back(Step{it->first, std::move(messages), nullptr});
+                        messages.clear();
+                    }
+
+                    steps.push_back(Step{it->first, {}, std::move(job->callback)});
+                } else if (job->message) {
+                    messages.push_back(job->message);
+                    playSound |= job->highlightSound;
+                    doAlert |= job->highlightAlert;
+                }
+
+                // released below, outside of the lock
+                finishedJobs.push_back(std::move(job));
+            }
+
+            if (!messages.empty()) {
+                steps.push_back(Step{it->first, std::move(messages), nullptr});
+            }
+
+            if (queue.empty()) {
+                it = this->queues.erase(it);
+            } else {
+                it++;
+            }
+        }
+    }
+
+    for (Step &step : steps) {
+        if (step.callback) {
+            step.callback();
+        } else {
+            step.channel->addMessages(step.messages);
+        }
+    }
+
+    if (playSound || doAlert) {
+        triggerHighlight(playSound, doAlert);
+    }
+}
+
+}  // namespace twitch
+}  // namespace chatterino
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "messages/message.hpp"
+#include "messages/messageparseargs.hpp"
+#include "messages/parsecontext.hpp"
+
+#include <QByteArray>
+#include <QThreadPool>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace chatterino {
+class Channel;
+
+namespace twitch {
+
+//
+// Parses twitch chat messages on a pool of worker threads.
+//
+// - push() and pushEvent() are only called on the gui thread
+// - the parsed messages are added to their channel on the gui thread, in the order they were
+//   pushed for that channel. Messages that are done at the same time are added in one batch.
+// - a slow message only holds back the messages and events of its own channel
+// - the channels are only released on the gui thread
+//
+class TwitchParsePipeline
+{
+public:
+    TwitchParsePipeline();
+    ~TwitchParsePipeline();
+
+    TwitchParsePipeline(const TwitchParsePipeline &) = delete;
+    TwitchParsePipeline &operator=(const TwitchParsePipeline &) = delete;
+
+    // queues the raw PRIVMSG line to be parsed for the channel
+    void push(const std::shared_ptr<Channel> &channel, const QByteArray &ircData,
+              const messages::MessageParseArgs &args);
+
+    // runs the callback on the gui thread after the messages that were pushed for the channel
+    // before it were added, used for events such as timeouts. Runs it right away if the channel
+    // has no messages queued.
+    void pushEvent(const std::shared_ptr<Channel> &channel, std::function<void()> callback);
+
+    // runs the task on the parse threads, e.g. to restore messages from the cold storage
+    void runTask(std::function<void()> task);
+
+private:
+    struct Job {
+        std::shared_ptr<Channel> channel;
+        QByteArray ircData;
+        messages::MessageParseArgs args;
+        std::shared_ptr<const messages::ParseContext> context;
+
+        messages::MessagePtr message;
+        bool highlightSound = false;
+        bool highlightAlert = false;
+        bool done = false;
+
+        // set for events, they are done when they are pushed
+        std::function<void()> callback;
+    };
+
+    void parse(Job &job);
+    void deliver();
+
+    QThreadPool threadPool;
+
+    std::mutex mutex;
+    std::map<std::shared_ptr<Channel>, std::deque<std::unique_ptr<Job>>> queues;
+    bool deliveryQueued = false;
+};
+
+}  // namespace twitch
+}  // namespace chatterino
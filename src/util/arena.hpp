@@ -0,0 +1,106 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace chatterino {
+namespace util {
+
+//
+// Bump allocator for objects that all die at the same time.
+//
+// - memory is taken from blocks, every block is twice as large as the one before
+// - memory is only returned when the arena is destroyed
+// - the arena doesn't know what is stored in it, the owner has to call the destructors
+//
+class Arena : boost::noncopyable
+{
+public:
+    explicit Arena(size_t _firstBlockSize = 1024)
+        : firstBlockSize(_firstBlockSize)
+    {
+    }
+
+    ~Arena()
+    {
+        Block *block = this->blocks;
+
+        while (block != nullptr) {
+            Block *next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+    }
+
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        uintptr_t position = (this->current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+        if (this->blocks == nullptr || position + size > this->end) {
+            this->addBlock(size + alignment);
+
+            position = (this->current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        }
+
+        this->current = position + size;
+        this->used += size;
+
+        return reinterpret_cast<void *>(position);
+    }
+
+    template <typename T, typename... Args>
+    T *create(Args &&... args)
+    {
+        return new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // bytes taken from the heap
+    size_t getCapacity() const
+    {
+        return this->capacity;
+    }
+
+    // bytes handed out by allocate
+    size_t getUsed() const
+    {
+        return this->used;
+    }
+
+private:
+    struct alignas(std::max_align_t) Block {
+        Block *next;
+    };
+
+    void addBlock(size_t minimumSize)
+    {
+        size_t size = std::max(minimumSize, this->blocks == nullptr ? this->firstBlockSize
+                                                                     : this->lastBlockSize * 2);
+
+        Block *block = static_cast<Block *>(::operator new(sizeof(Block) + size));
+        block->next = this->blocks;
+
+        this->blocks = block;
+        this->lastBlockSize = size;
+        this->capacity += sizeof(Block) + size;
+
+        this->current = reinterpret_cast<uintptr_t>(block + 1);
+        this->end = this->current + size;
+    }
+
+    size_t firstBlockSize;
+    size_t lastBlockSize = 0;
+    size_t capacity = 0;
+    size_t used = 0;
+
+    Block *blocks = nullptr;
+    uintptr_t current = 0;
+    uintptr_t end = 0;
+};
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,110 @@
+#include "util/emojitrie.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+namespace util {
+
+EmojiTrie::EmojiTrie()
+    : nodes{Node{0, 0, -1}}
+{
+}
+
+EmojiTrie::EmojiTrie(Sequences sequences)
+    : EmojiTrie()
+{
+    sequences.erase(std::remove_if(sequences.begin(), sequences.end(),
+                                   [](const std::pair<QString, int> &sequence) {
+                                       return sequence.first.isEmpty();  //
+                                   }),
+                    sequences.end());
+
+    // stable, so duplicates stay in the order they were given in
+    std::stable_sort(sequences.begin(), sequences.end(),
+                     [](const std::pair<QString, int> &a, const std::pair<QString, int> &b) {
+                         return a.first < b.first;  //
+                     });
+
+    this->build(sequences, 0, 0, int(sequences.size()), 0);
+}
+
+int EmojiTrie::findLongest(const QChar *begin, const QChar *end, int &value) const
+{
+    int matchedLength = 0;
+    int node = 0;
+
+    for (const QChar *it = begin; it != end; it++) {
+        const Node &current = this->nodes[node];
+
+        auto keysBegin = this->edgeKeys.begin() + current.firstEdge;
+        auto keysEnd = keysBegin + current.edgeCount;
+        auto key = std::lower_bound(keysBegin, keysEnd, it->unicode());
+
+        if (key == keysEnd || *key != it->unicode()) {
+            break;
+        }
+
+        node = this->edgeTargets[key - this->edgeKeys.begin()];
+
+        if (this->nodes[node].value != -1) {
+            matchedLength = int(it - begin) + 1;
+            value = this->nodes[node].value;
+        }
+    }
+
+    return matchedLength;
+}
+
+bool EmojiTrie::isEmpty() const
+{
+    return this->nodes[0].edgeCount == 0;
+}
+
+void EmojiTrie::build(const Sequences &sequences, int node, int first, int last, int depth)
+{
+    // all sequences in [first, last) share their first `depth` code units, the ones that end here
+    // sort before the longer ones
+    if (first != last && sequences[first].first.size() == depth) {
+        this->nodes[node].value = sequences[first].second;
+
+        while (first != last && sequences[first].first.size() == depth) {
+            first++;
+        }
+    }
+
+    // add the edges of this node first so they end up next to each other
+    this->nodes[node].firstEdge = int(this->edgeKeys.size());
+
+    for (int i = first; i != last; i++) {
+        ushort key = sequences[i].first.at(depth).unicode();
+
+        if (i == first || key != this->edgeKeys.back()) {
+            this->edgeKeys.push_back(key);
+            this->edgeTargets.push_back(-1);
+        }
+    }
+
+    this->nodes[node].edgeCount = int(this->edgeKeys.size()) - this->nodes[node].firstEdge;
+
+    int edge = this->nodes[node].firstEdge;
+
+    for (int childFirst = first; childFirst != last; edge++) {
+        ushort key = this->edgeKeys[edge];
+        int childLast = childFirst;
+
+        while (childLast != last && sequences[childLast].first.at(depth).unicode() == key) {
+            childLast++;
+        }
+
+        int child = int(this->nodes.size());
+        this->nodes.push_back(Node{0, 0, -1});
+        this->edgeTargets[edge] = child;
+
+        this->build(sequences, child, childFirst, childLast, depth + 1);
+
+        childFirst = childLast;
+    }
+}
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QChar>
+#include <QString>
+
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+namespace util {
+
+//
+// Immutable trie over the utf-16 code units of the emoji sequences
+//
+// - the children of a node are stored next to each other and sorted, so a step is one binary
+//   search over a contiguous array
+// - findLongest walks the text once and remembers the last sequence that ended, so "family"
+//   sequences win over the single emoji they start with
+// - lookups never allocate, the trie can be read from any thread
+//
+class EmojiTrie
+{
+public:
+    typedef std::vector<std::pair<QString, int>> Sequences;
+
+    EmojiTrie();
+
+    // if the same sequence is given more than once the first value is kept, empty sequences are
+    // skipped
+    explicit EmojiTrie(Sequences sequences);
+
+    // Returns the length in code units of the longest sequence that `begin` starts with and sets
+    // `value` to its value, returns 0 if none matches
+    int findLongest(const QChar *begin, const QChar *end, int &value) const;
+
+    bool isEmpty() const;
+
+private:
+    struct Node {
+        int firstEdge;
+        int edgeCount;
+
+        // -1 if no sequence ends here
+        int value;
+    };
+
+    void build(const Sequences &sequences, int node, int first, int last, int depth);
+
+    std::vector<Node> nodes;
+
+    // edges are split up so the binary search only touches the keys
+    std::vector<ushort> edgeKeys;
+    std::vector<int> edgeTargets;
+};
+
+}  // namespace util
+}  // namespace chatterino
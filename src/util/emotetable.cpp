@@ -0,0 +1,120 @@
+#include "util/emotetable.hpp"
+
+#include <QHash>
+
+namespace chatterino {
+namespace util {
+
+namespace {
+
+uint nextPowerOfTwo(uint value)
+{
+    uint result = 1;
+
+    while (result < value) {
+        result <<= 1;
+    }
+
+    return result;
+}
+
+// second bloom filter index, derived from the same hash
+uint rehash(uint hash)
+{
+    return (hash * 0x9e3779b1u) >> 7;
+}
+
+}  // namespace
+
+EmoteTable::EmoteTable(const Sources &sources)
+{
+    // copy the sources first, the maps are locked while iterating them
+    std::vector<std::pair<QString, Emote>> entries;
+
+    for (const auto &source : sources) {
+        if (source.first == nullptr) {
+            continue;
+        }
+
+        messages::MessageElement::Flags flags = source.second;
+
+        source.first->each([&entries, flags](const QString &code, const EmoteData &data) {
+            entries.emplace_back(code, Emote{data, flags});  //
+        });
+    }
+
+    // at most half full, 16 bloom filter bits per emote
+    this->slots.assign(nextPowerOfTwo(uint(entries.size()) * 2 + 1), Slot{0, -1});
+    this->slotMask = uint(this->slots.size()) - 1;
+
+    this->bloom.assign(nextPowerOfTwo(uint(entries.size()) / 4 + 1), 0);
+    this->bloomMask = uint(this->bloom.size()) * 64 - 1;
+
+    this->codes.reserve(entries.size());
+    this->emotes.reserve(entries.size());
+
+    for (const auto &entry : entries) {
+        this->insert(entry.first, entry.second);
+    }
+}
+
+const EmoteTable::Emote *EmoteTable::find(const QString &code) const
+{
+    uint hash = qHash(code);
+
+    if (!this->mightContain(hash)) {
+        return nullptr;
+    }
+
+    for (uint i = hash & this->slotMask;; i = (i + 1) & this->slotMask) {
+        const Slot &slot = this->slots[i];
+
+        if (slot.index == -1) {
+            return nullptr;
+        }
+
+        if (slot.hash == hash && this->codes[slot.index] == code) {
+            return &this->emotes[slot.index];
+        }
+    }
+}
+
+size_t EmoteTable::size() const
+{
+    return this->emotes.size();
+}
+
+void EmoteTable::insert(const QString &code, const Emote &emote)
+{
+    uint hash = qHash(code);
+    uint i = hash & this->slotMask;
+
+    for (; this->slots[i].index != -1; i = (i + 1) & this->slotMask) {
+        // a source with a higher precedence already has this code
+        if (this->slots[i].hash == hash && this->codes[this->slots[i].index] == code) {
+            return;
+        }
+    }
+
+    this->slots[i] = Slot{hash, int(this->emotes.size())};
+    this->codes.push_back(code);
+    this->emotes.push_back(emote);
+
+    uint bit1 = hash & this->bloomMask;
+    uint bit2 = rehash(hash) & this->bloomMask;
+
+    this->bloom[bit1 / 64] |= uint64_t(1) << (bit1 % 64);
+    this->bloom[bit2 / 64] |= uint64_t(1) << (bit2 % 64);
+}
+
+bool EmoteTable::mightContain(uint hash) const
+{
+    uint bit1 = hash & this->bloomMask;
+    uint bit2 = rehash(hash) & this->bloomMask;
+
+    return (this->bloom[bit1 / 64] & (uint64_t(1) << (bit1 % 64))) != 0 &&
+           (this->bloom[bit2 / 64] & (uint64_t(1) << (bit2 % 64))) != 0;
+}
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "messages/messageelement.hpp"
+#include "util/emotemap.hpp"
+
+#include <QString>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+namespace util {
+
+//
+// Immutable merge of several emote maps
+//
+// - the sources are merged in order of precedence, the first source that has a code wins
+// - every emote remembers the element flags of the source it came from
+// - a bloom filter in front of the open addressing table rejects most words (which are not
+//   emotes) without touching the table
+// - the table is never modified after it was built, so it can be read from any thread
+//
+class EmoteTable
+{
+public:
+    struct Emote {
+        EmoteData data;
+        messages::MessageElement::Flags flags;
+    };
+
+    typedef std::vector<std::pair<const EmoteMap *, messages::MessageElement::Flags>> Sources;
+
+    // null sources are skipped
+    explicit EmoteTable(const Sources &sources);
+
+    // returns nullptr if none of the sources has an emote with that code
+    const Emote *find(const QString &code) const;
+
+    size_t size() const;
+
+private:
+    struct Slot {
+        uint hash;
+        int index;
+    };
+
+    void insert(const QString &code, const Emote &emote);
+    bool mightContain(uint hash) const;
+
+    std::vector<QString> codes;
+    std::vector<Emote> emotes;
+
+    std::vector<Slot> slots;
+    uint slotMask = 0;
+
+    std::vector<uint64_t> bloom;
+    uint bloomMask = 0;
+};
+
+}  // namespace util
+}  // namespace chatterino
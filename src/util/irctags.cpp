@@ -0,0 +1,237 @@
+#include "util/irctags.hpp"
+
+#include <cstring>
+
+namespace chatterino {
+namespace util {
+
+namespace {
+
+struct KnownTag {
+    const char *name;
+    IrcTagValue IrcTags::*member;
+};
+
+const KnownTag knownTags[] = {
+    {"badges", &IrcTags::badges},
+    {"ban-duration", &IrcTags::banDuration},
+    {"ban-reason", &IrcTags::banReason},
+    {"bits", &IrcTags::bits},
+    {"color", &IrcTags::color},
+    {"display-name", &IrcTags::displayName},
+    {"emotes", &IrcTags::emotes},
+    {"historical", &IrcTags::historical},
+    {"id", &IrcTags::id},
+    {"login", &IrcTags::login},
+    {"msg-id", &IrcTags::msgId},
+    {"room-id", &IrcTags::roomId},
+    {"target-msg-id", &IrcTags::targetMsgId},
+    {"tmi-sent-ts", &IrcTags::tmiSentTs},
+    {"user-id", &IrcTags::userId},
+};
+
+IrcTagValue IrcTags::*findKnownTag(const char *key, int length)
+{
+    for (const KnownTag &tag : knownTags) {
+        if (std::strncmp(tag.name, key, size_t(length)) == 0 && tag.name[length] == '\0') {
+            return tag.member;
+        }
+    }
+
+    return nullptr;
+}
+
+}  // namespace
+
+// IrcTagValue
+IrcTagValue::IrcTagValue(const char *_data, int _size)
+    : begin(_data)
+    , length(_size)
+{
+}
+
+bool IrcTagValue::isPresent() const
+{
+    return this->begin != nullptr;
+}
+
+bool IrcTagValue::isEmpty() const
+{
+    return this->length == 0;
+}
+
+const char *IrcTagValue::data() const
+{
+    return this->begin;
+}
+
+int IrcTagValue::size() const
+{
+    return this->length;
+}
+
+bool IrcTagValue::equals(const char *string) const
+{
+    int stringLength = int(std::strlen(string));
+
+    return stringLength == this->length && std::memcmp(this->begin, string, stringLength) == 0;
+}
+
+bool IrcTagValue::startsWith(const char *string) const
+{
+    int stringLength = int(std::strlen(string));
+
+    return stringLength <= this->length && std::memcmp(this->begin, string, stringLength) == 0;
+}
+
+QString IrcTagValue::toString() const
+{
+    if (this->length == 0) {
+        return QString();
+    }
+
+    const char *escape =
+        static_cast<const char *>(std::memchr(this->begin, '\\', size_t(this->length)));
+
+    if (escape == nullptr) {
+        return QString::fromUtf8(this->begin, this->length);
+    }
+
+    QByteArray unescaped;
+    unescaped.reserve(this->length);
+    unescaped.append(this->begin, int(escape - this->begin));
+
+    const char *end = this->begin + this->length;
+
+    for (const char *it = escape; it != end; it++) {
+        if (*it != '\\') {
+            unescaped.append(*it);
+            continue;
+        }
+
+        // a trailing backslash is dropped
+        if (++it == end) {
+            break;
+        }
+
+        switch (*it) {
+            case ':': {
+                unescaped.append(';');
+            } break;
+
+            case 's': {
+                unescaped.append(' ');
+            } break;
+
+            case 'r': {
+                unescaped.append('\r');
+            } break;
+
+            case 'n': {
+                unescaped.append('\n');
+            } break;
+
+            default: {
+                unescaped.append(*it);
+            } break;
+        }
+    }
+
+    return QString::fromUtf8(unescaped);
+}
+
+qint64 IrcTagValue::toLongLong(bool *ok) const
+{
+    const char *it = this->begin;
+    const char *end = this->begin + this->length;
+
+    bool negative = it != end && *it == '-';
+    if (negative) {
+        it++;
+    }
+
+    qint64 value = 0;
+    bool valid = it != end;
+
+    for (; it != end; it++) {
+        if (*it < '0' || *it > '9') {
+            valid = false;
+            break;
+        }
+
+        value = value * 10 + (*it - '0');
+    }
+
+    if (ok != nullptr) {
+        *ok = valid;
+    }
+
+    if (!valid) {
+        return 0;
+    }
+
+    return negative ? -value : value;
+}
+
+// IrcTags
+IrcTags::IrcTags(const QByteArray &line)
+{
+    if (!line.startsWith('@')) {
+        return;
+    }
+
+    const char *it = line.constData() + 1;
+    const char *end = line.constData() + line.size();
+
+    // the tags end at the first space
+    const char *tagsEnd = static_cast<const char *>(std::memchr(it, ' ', size_t(end - it)));
+    if (tagsEnd == nullptr) {
+        tagsEnd = end;
+    }
+
+    while (it < tagsEnd) {
+        const char *tagEnd = static_cast<const char *>(std::memchr(it, ';', size_t(tagsEnd - it)));
+        if (tagEnd == nullptr) {
+            tagEnd = tagsEnd;
+        }
+
+        const char *equals = static_cast<const char *>(std::memchr(it, '=', size_t(tagEnd - it)));
+        const char *keyEnd = equals != nullptr ? equals : tagEnd;
+        const char *valueBegin = equals != nullptr ? equals + 1 : tagEnd;
+
+        IrcTagValue key(it, int(keyEnd - it));
+        IrcTagValue value(valueBegin, int(tagEnd - valueBegin));
+
+        if (!key.isEmpty()) {
+            IrcTagValue IrcTags::*member = findKnownTag(key.data(), key.size());
+
+            if (member != nullptr) {
+                this->*member = value;
+            } else {
+                this->otherTags.emplace_back(key, value);
+            }
+        }
+
+        it = tagEnd + 1;
+    }
+}
+
+IrcTagValue IrcTags::get(const char *name) const
+{
+    IrcTagValue IrcTags::*member = findKnownTag(name, int(std::strlen(name)));
+
+    if (member != nullptr) {
+        return this->*member;
+    }
+
+    for (const auto &tag : this->otherTags) {
+        if (tag.first.equals(name)) {
+            return tag.second;
+        }
+    }
+
+    return IrcTagValue();
+}
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <boost/container/small_vector.hpp>
+
+#include <utility>
+
+namespace chatterino {
+namespace util {
+
+//
+// Value of an IRCv3 message tag
+//
+// - points into the raw line the tags were parsed from, the line has to outlive the value
+// - the value is kept escaped, toString() unescapes it
+// - a tag without a value ("@tag;" or "@tag=;") is present but empty
+//
+class IrcTagValue
+{
+public:
+    IrcTagValue() = default;
+    IrcTagValue(const char *_data, int _size);
+
+    bool isPresent() const;
+    bool isEmpty() const;
+
+    const char *data() const;
+    int size() const;
+
+    // compares the raw value
+    bool equals(const char *string) const;
+    bool startsWith(const char *string) const;
+
+    // unescapes "\:", "\s", "\\", "\r" and "\n" and decodes the value as UTF-8
+    QString toString() const;
+
+    // decimal integer, ok is set to false if the value isn't one
+    qint64 toLongLong(bool *ok = nullptr) const;
+
+private:
+    const char *begin = nullptr;
+    int length = 0;
+};
+
+//
+// Tags of a raw IRC line
+//
+// The tags twitch sends with chat messages, timeouts and deleted messages are parsed into the
+// members below. Every other tag is kept in `otherTags`. Nothing is copied or unescaped while
+// parsing.
+//
+class IrcTags
+{
+public:
+    IrcTags() = default;
+
+    // the line has to outlive the tags since the values point into it
+    explicit IrcTags(const QByteArray &line);
+
+    IrcTagValue badges;
+    IrcTagValue banDuration;
+    IrcTagValue banReason;
+    IrcTagValue bits;
+    IrcTagValue color;
+    IrcTagValue displayName;
+    IrcTagValue emotes;
+    IrcTagValue historical;
+    IrcTagValue id;
+    IrcTagValue login;
+    IrcTagValue msgId;
+    IrcTagValue roomId;
+    IrcTagValue targetMsgId;
+    IrcTagValue tmiSentTs;
+    IrcTagValue userId;
+
+    // key and value of the tags that don't have a member, in the order they were sent
+    boost::container::small_vector<std::pair<IrcTagValue, IrcTagValue>, 16> otherTags;
+
+    // looks up any tag by its name
+    IrcTagValue get(const char *name) const;
+};
+
+}  // namespace util
+}  // namespace chatterino
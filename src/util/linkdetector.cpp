@@ -0,0 +1,368 @@
+#include "util/linkdetector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+
+namespace chatterino {
+namespace util {
+
+namespace {
+
+enum CharClass : uint8_t {
+    HostChar = (1 << 0),
+    Digit = (1 << 1),
+    // punctuation that ends a sentence or a quote, never the last character of a link
+    Trailing = (1 << 2),
+    Opening = (1 << 3),
+    Closing = (1 << 4),
+    // starts the path, query or fragment
+    PathStart = (1 << 5),
+};
+
+const std::array<uint8_t, 128> charClasses = [] {
+    std::array<uint8_t, 128> classes{};
+
+    for (char c = 'a'; c <= 'z'; c++) {
+        classes[c] |= HostChar;
+        classes[c - 'a' + 'A'] |= HostChar;
+    }
+
+    for (char c = '0'; c <= '9'; c++) {
+        classes[c] |= HostChar | Digit;
+    }
+
+    classes['-'] |= HostChar;
+
+    for (char c : {'.', ',', ';', ':', '!', '?', '\'', '"'}) {
+        classes[c] |= Trailing;
+    }
+
+    for (char c : {'(', '[', '{', '<', '\'', '"'}) {
+        classes[c] |= Opening;
+    }
+
+    for (char c : {')', ']', '}', '>'}) {
+        classes[c] |= Closing;
+    }
+
+    for (char c : {'/', '?', '#'}) {
+        classes[c] |= PathStart;
+    }
+
+    return classes;
+}();
+
+// sorted, compared case insensitively
+const char *const topLevelDomains[] = {
+    "ac", "academy", "ad", "ae", "aero", "af", "ag", "agency", "ai", "al", "am", "ao", "app", "aq",
+    "ar", "art", "as", "asia", "at", "au", "aw", "ax", "az", "ba", "bb", "bd", "be", "bf", "bg",
+    "bh", "bi", "biz", "bj", "black", "blog", "blue", "bm", "bn", "bo", "br", "bs", "bt", "bw",
+    "by", "bz", "ca", "cafe", "cat", "cc", "cd", "center", "cf", "cg", "ch", "chat", "ci", "city",
+    "ck", "cl", "cloud", "club", "cm", "cn", "co", "com", "company", "coop", "cr", "cu", "cv", "cw",
+    "cx", "cy", "cz", "de", "design", "dev", "digital", "dj", "dk", "dm", "do", "dz", "ec", "edu",
+    "ee", "eg", "email", "er", "es", "et", "eu", "events", "fail", "family", "fi", "film", "fj",
+    "fk", "fm", "fo", "fr", "fun", "ga", "gallery", "game", "games", "gb", "gd", "ge", "gf", "gg",
+    "gh", "gi", "gl", "global", "gm", "gn", "gov", "gp", "gq", "gr", "group", "gs", "gt", "gu",
+    "gw", "gy", "hk", "hm", "hn", "host", "hr", "ht", "hu", "id", "ie", "il", "im", "in", "info",
+    "ink", "int", "io", "iq", "ir", "is", "it", "je", "jm", "jo", "jobs", "jp", "ke", "kg", "kh",
+    "ki", "km", "kn", "kp", "kr", "kw", "ky", "kz", "la", "land", "lb", "lc", "li", "life", "link",
+    "live", "lk", "lol", "lr", "ls", "lt", "ltd", "lu", "lv", "ly", "ma", "market", "mc", "md",
+    "me", "media", "mg", "mh", "mil", "mk", "ml", "mm", "mn", "mo", "mobi", "moe", "money", "mp",
+    "mq", "mr", "ms", "mt", "mu", "museum", "music", "mv", "mw", "mx", "my", "mz", "na", "name",
+    "nc", "ne", "net", "network", "news", "nf", "ng", "ni", "ninja", "nl", "no", "np", "nr", "nu",
+    "nz", "om", "one", "online", "org", "pa", "page", "pe", "pf", "pg", "ph", "photo", "photos",
+    "pink", "pk", "pl", "pm", "pn", "pr", "press", "pro", "ps", "pt", "pw", "py", "qa", "radio",
+    "re", "red", "ro", "rocks", "rs", "ru", "rw", "sa", "sb", "sc", "school", "sd", "se", "sg",
+    "sh", "shop", "si", "site", "sk", "sl", "sm", "sn", "so", "social", "software", "space", "sr",
+    "ss", "st", "store", "stream", "studio", "su", "sv", "sx", "sy", "systems", "sz", "tc", "td",
+    "team", "tech", "tel", "tf", "tg", "th", "tips", "tj", "tk", "tl", "tm", "tn", "to", "today",
+    "tools", "top", "tr", "travel", "tt", "tv", "tw", "tz", "ua", "ug", "uk", "us", "uy", "uz",
+    "va", "vc", "ve", "vg", "vi", "video", "vn", "vu", "website", "wf", "wiki", "win", "work",
+    "world", "ws", "wtf", "xxx", "xyz", "ye", "yt", "za", "zm", "zone", "zw",
+};
+
+// internationalized top level domains that are in use, lower case
+const char16_t *const idnTopLevelDomains[] = {
+    u"\u0440\u0444",                                      // рф
+    u"\u0440\u0443\u0441",                                // рус
+    u"\u043e\u043d\u043b\u0430\u0439\u043d",              // онлайн
+    u"\u0441\u0430\u0439\u0442",                          // сайт
+    u"\u0443\u043a\u0440",                                // укр
+    u"\u0431\u0435\u043b",                                // бел
+    u"\u0441\u0440\u0431",                                // срб
+    u"\u049b\u0430\u0437",                                // қаз
+    u"\u043c\u043a\u0434",                                // мкд
+    u"\u043c\u043e\u043d",                                // мон
+    u"\u0431\u0433",                                      // бг
+    u"\u0435\u044e",                                      // ею
+    u"\u03b5\u03bb",                                      // ελ
+    u"\u03b5\u03c5",                                      // ευ
+    u"\u10d2\u10d4",                                      // გე
+    u"\u0570\u0561\u0575",                                // հայ
+    u"\u4e2d\u56fd",                                      // 中国
+    u"\u4e2d\u570b",                                      // 中國
+    u"\u516c\u53f8",                                      // 公司
+    u"\u7f51\u7edc",                                      // 网络
+    u"\u9999\u6e2f",                                      // 香港
+    u"\u53f0\u6e7e",                                      // 台湾
+    u"\u53f0\u7063",                                      // 台灣
+    u"\u65b0\u52a0\u5761",                                // 新加坡
+    u"\u307f\u3093\u306a",                                // みんな
+    u"\ud55c\uad6d",                                      // 한국
+    u"\u0e44\u0e17\u0e22",                                // ไทย
+    u"\u092d\u093e\u0930\u0924",                          // भारत
+    u"\u0645\u0635\u0631",                                // مصر
+    u"\u0627\u06cc\u0631\u0627\u0646",                    // ایران
+    u"\u0627\u0645\u0627\u0631\u0627\u062a",              // امارات
+    u"\u0627\u0644\u0633\u0639\u0648\u062f\u064a\u0629",  // السعودية
+};
+
+uint8_t classify(QChar character)
+{
+    ushort unicode = character.unicode();
+
+    return unicode < 128 ? charClasses[unicode] : 0;
+}
+
+bool is(QChar character, uint8_t charClass)
+{
+    return (classify(character) & charClass) != 0;
+}
+
+bool isHostCharacter(QChar character)
+{
+    if (character.unicode() < 128) {
+        return is(character, HostChar);
+    }
+
+    // internationalized host names
+    return character.isLetterOrNumber() || character.isMark();
+}
+
+QChar toLowerAscii(QChar character)
+{
+    ushort unicode = character.unicode();
+
+    return unicode >= 'A' && unicode <= 'Z' ? QChar(unicode + ('a' - 'A')) : character;
+}
+
+bool startsWith(const QChar *it, const QChar *end, const char *prefix)
+{
+    for (; *prefix != '\0'; it++, prefix++) {
+        if (it == end || toLowerAscii(*it) != QChar(*prefix)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// compares an ascii label with a lower case string, like strcmp
+int compareLabel(const QChar *label, int length, const char *string)
+{
+    for (int i = 0; i < length; i++, string++) {
+        if (*string == '\0') {
+            return 1;
+        }
+
+        int difference = int(toLowerAscii(label[i]).unicode()) - int(uchar(*string));
+
+        if (difference != 0) {
+            return difference;
+        }
+    }
+
+    return *string == '\0' ? 0 : -1;
+}
+
+bool isIdnTopLevelDomain(const QChar *label, int length)
+{
+    for (const char16_t *domain : idnTopLevelDomains) {
+        int i = 0;
+
+        while (i < length && domain[i] != 0 && label[i].toLower().unicode() == domain[i]) {
+            i++;
+        }
+
+        if (i == length && domain[i] == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool isTopLevelDomain(const QChar *label, int length)
+{
+    bool ascii = std::all_of(label, label + length, [](QChar c) {
+        return c.unicode() < 128;  //
+    });
+
+    // text with a missing space after a period, like "ok.ça", is not a link
+    if (!ascii) {
+        return isIdnTopLevelDomain(label, length);
+    }
+
+    if (startsWith(label, label + length, "xn--")) {
+        return length > 4;
+    }
+
+    auto it = std::lower_bound(std::begin(topLevelDomains), std::end(topLevelDomains), label,
+                               [length](const char *domain, const QChar *value) {
+                                   return compareLabel(value, length, domain) > 0;
+                               });
+
+    return it != std::end(topLevelDomains) && compareLabel(label, length, *it) == 0;
+}
+
+bool isByte(const QChar *label, int length)
+{
+    if (length == 0 || length > 3) {
+        return false;
+    }
+
+    int value = 0;
+
+    for (int i = 0; i < length; i++) {
+        if (!is(label[i], Digit)) {
+            return false;
+        }
+
+        value = value * 10 + (label[i].unicode() - '0');
+    }
+
+    return value <= 255;
+}
+
+}  // namespace
+
+bool detectLink(const QString &word, LinkMatch &match)
+{
+    const QChar *begin = word.constData();
+    const QChar *end = begin + word.size();
+    const QChar *it = begin;
+
+    // opening punctuation in front of the link
+    while (it != end && is(*it, Opening)) {
+        it++;
+    }
+
+    const QChar *linkBegin = it;
+
+    // scheme
+    bool hasScheme = false;
+
+    if (startsWith(it, end, "http://")) {
+        it += 7;
+        hasScheme = true;
+    } else if (startsWith(it, end, "https://")) {
+        it += 8;
+        hasScheme = true;
+    }
+
+    // host, labels separated by dots
+    int labels = 0;
+    bool ipv4 = true;
+    const QChar *labelBegin;
+
+    while (true) {
+        labelBegin = it;
+
+        while (it != end && isHostCharacter(*it)) {
+            it++;
+        }
+
+        int length = int(it - labelBegin);
+
+        if (length == 0 || length > 63 || *labelBegin == '-' || *(it - 1) == '-') {
+            return false;
+        }
+
+        labels++;
+        ipv4 = ipv4 && isByte(labelBegin, length);
+
+        if (it != end && *it == '.' && it + 1 != end && isHostCharacter(*(it + 1))) {
+            it++;
+            continue;
+        }
+
+        break;
+    }
+
+    if (!hasScheme) {
+        bool validHost = ipv4 ? labels == 4
+                              : labels >= 2 && isTopLevelDomain(labelBegin, int(it - labelBegin));
+
+        if (!validHost) {
+            return false;
+        }
+    }
+
+    // port
+    if (it != end && *it == ':' && it + 1 != end && is(*(it + 1), Digit)) {
+        int port = 0;
+        const QChar *portBegin = ++it;
+
+        while (it != end && is(*it, Digit)) {
+            port = port * 10 + (it->unicode() - '0');
+
+            if (it - portBegin >= 5 || port > 65535) {
+                return false;
+            }
+
+            it++;
+        }
+
+        if (port == 0) {
+            return false;
+        }
+    }
+
+    // path, query and fragment take the rest of the word
+    const QChar *linkEnd = it;
+
+    if (it != end && is(*it, PathStart)) {
+        linkEnd = end;
+    }
+
+    // closing brackets only belong to the link if they are balanced within it
+    int unbalancedParentheses = 0;
+    int unbalancedBrackets = 0;
+
+    for (const QChar *c = it; c != linkEnd; c++) {
+        unbalancedParentheses += *c == '(' ? -1 : *c == ')' ? 1 : 0;
+        unbalancedBrackets += *c == '[' ? -1 : *c == ']' ? 1 : 0;
+    }
+
+    while (linkEnd != it) {
+        QChar last = *(linkEnd - 1);
+
+        if (last == ')' && unbalancedParentheses > 0) {
+            unbalancedParentheses--;
+        } else if (last == ']' && unbalancedBrackets > 0) {
+            unbalancedBrackets--;
+        } else if (!is(last, Trailing)) {
+            break;
+        }
+
+        linkEnd--;
+    }
+
+    // whatever follows the link has to be punctuation
+    for (const QChar *c = linkEnd; c != end; c++) {
+        if (!is(*c, Trailing | Closing)) {
+            return false;
+        }
+    }
+
+    match.start = int(linkBegin - begin);
+    match.length = int(linkEnd - linkBegin);
+    match.hasScheme = hasScheme;
+
+    return true;
+}
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QString>
+
+namespace chatterino {
+namespace util {
+
+struct LinkMatch {
+    // the link without the punctuation around it
+    int start = 0;
+    int length = 0;
+
+    // starts with http:// or https://
+    bool hasScheme = false;
+};
+
+// Recognizes a link in a single word (no spaces) in one pass without allocating.
+//
+// - the host needs a known top level domain or to be an ipv4 address, so "file.txt", "Mr.Smith"
+//   or "ok.ça" are not links. With an explicit scheme any host is accepted
+// - internationalized host names are accepted as they are, the caller doesn't need to convert
+//   them to punycode
+// - ports have to be between 1 and 65535
+// - punctuation around the link is not part of it, closing brackets only if they are not
+//   balanced within the link: "(example.com/a_(b))." gives "example.com/a_(b)"
+bool detectLink(const QString &word, LinkMatch &match);
+
+}  // namespace util
+}  // namespace chatterino
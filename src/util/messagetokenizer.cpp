@@ -0,0 +1,229 @@
+#include "util/messagetokenizer.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TOKENIZER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TOKENIZER_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace chatterino {
+namespace util {
+
+namespace {
+
+bool isEmojiUnit(ushort unit)
+{
+    return unit == 0xa9 || unit == 0xae || (unit >= 0x2000 && unit < 0x3300) ||
+           (unit >= 0xd83c && unit <= 0xd83e);
+}
+
+// what can follow the '.' of a host name
+bool isHostUnit(ushort unit)
+{
+    return (unit >= 'a' && unit <= 'z') || (unit >= 'A' && unit <= 'Z') ||
+           (unit >= '0' && unit <= '9') || unit >= 0x80;
+}
+
+bool isHighSurrogate(ushort unit)
+{
+    return unit >= 0xd800 && unit < 0xdc00;
+}
+
+bool isLowSurrogate(ushort unit)
+{
+    return unit >= 0xdc00 && unit < 0xe000;
+}
+
+#if defined(TOKENIZER_AVX2) || defined(TOKENIZER_SSE2)
+int countTrailingZeros(uint value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return int(index);
+#else
+    return __builtin_ctz(value);
+#endif
+}
+#endif
+
+#if defined(TOKENIZER_AVX2)
+const int blockSize = 16;
+
+// the masks have two bits per code unit, like movemask returns them
+void classifyBlock(const ushort *block, uint &spaces, uint &special)
+{
+    __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+
+    __m256i space = _mm256_cmpeq_epi16(units, _mm256_set1_epi16(' '));
+    __m256i dot = _mm256_cmpeq_epi16(units, _mm256_set1_epi16('.'));
+    __m256i colon = _mm256_cmpeq_epi16(units, _mm256_set1_epi16(':'));
+    __m256i ascii = _mm256_cmpeq_epi16(_mm256_and_si256(units, _mm256_set1_epi16(short(0xff80))),
+                                       _mm256_setzero_si256());
+
+    spaces = uint(_mm256_movemask_epi8(space));
+    special = uint(_mm256_movemask_epi8(_mm256_or_si256(dot, colon))) |
+              ~uint(_mm256_movemask_epi8(ascii));
+}
+#elif defined(TOKENIZER_SSE2)
+const int blockSize = 8;
+
+// the masks have two bits per code unit, like movemask returns them
+void classifyBlock(const ushort *block, uint &spaces, uint &special)
+{
+    __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+
+    __m128i space = _mm_cmpeq_epi16(units, _mm_set1_epi16(' '));
+    __m128i dot = _mm_cmpeq_epi16(units, _mm_set1_epi16('.'));
+    __m128i colon = _mm_cmpeq_epi16(units, _mm_set1_epi16(':'));
+    __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16(short(0xff80))),
+                                    _mm_setzero_si128());
+
+    spaces = uint(_mm_movemask_epi8(space));
+    special = uint(_mm_movemask_epi8(_mm_or_si128(dot, colon))) |
+              (~uint(_mm_movemask_epi8(ascii)) & 0xffff);
+}
+#endif
+
+class Tokenizer
+{
+public:
+    Tokenizer(const ushort *_text, int _size, MessageTokens &_tokens)
+        : text(_text)
+        , size(_size)
+        , tokens(_tokens)
+    {
+    }
+
+    void scalar(int index)
+    {
+        ushort unit = this->text[index];
+
+        if (unit == ' ') {
+            this->end(index);
+            return;
+        }
+
+        this->begin(index);
+
+        if (unit >= 0x80) {
+            this->flags |= MessageToken::NonAscii;
+
+            if (isEmojiUnit(unit)) {
+                this->flags |= MessageToken::EmojiCandidate;
+            }
+
+            if (isLowSurrogate(unit) && index > 0 && isHighSurrogate(this->text[index - 1])) {
+                this->pairedLowSurrogates++;
+            }
+        } else if (index + 1 < this->size) {
+            ushort next = this->text[index + 1];
+
+            if ((unit == '.' && isHostUnit(next)) || (unit == ':' && next == '/')) {
+                this->flags |= MessageToken::UrlCandidate;
+            }
+        }
+    }
+
+#if defined(TOKENIZER_AVX2) || defined(TOKENIZER_SSE2)
+    // the block is ascii without any '.' or ':', so only the spaces matter
+    void fastBlock(int index, uint spaces)
+    {
+        int position = index;
+
+        while (spaces != 0) {
+            int space = index + countTrailingZeros(spaces) / 2;
+
+            if (space > position) {
+                this->begin(position);
+            }
+
+            this->end(space);
+            position = space + 1;
+
+            // clear both bits of the space
+            spaces &= spaces - 1;
+            spaces &= spaces - 1;
+        }
+
+        if (position < index + blockSize) {
+            this->begin(position);
+        }
+    }
+#endif
+
+    void end(int index)
+    {
+        if (this->tokenStart != -1) {
+            this->tokens.push_back(MessageToken{this->tokenStart, index - this->tokenStart,
+                                                this->codePointStart, this->flags});
+            this->tokenStart = -1;
+        }
+    }
+
+private:
+    void begin(int index)
+    {
+        if (this->tokenStart == -1) {
+            this->tokenStart = index;
+            this->codePointStart = index - this->pairedLowSurrogates;
+            this->flags = MessageToken::None;
+        }
+    }
+
+    const ushort *text;
+    int size;
+    MessageTokens &tokens;
+
+    int tokenStart = -1;
+    int codePointStart = 0;
+    uint8_t flags = MessageToken::None;
+
+    // every surrogate pair is two code units but one code point
+    int pairedLowSurrogates = 0;
+};
+
+}  // namespace
+
+void tokenizeMessage(const QString &text, MessageTokens &tokens)
+{
+    tokens.clear();
+
+    const ushort *units = reinterpret_cast<const ushort *>(text.constData());
+    int size = text.size();
+
+    Tokenizer tokenizer(units, size, tokens);
+
+    int i = 0;
+
+#if defined(TOKENIZER_AVX2) || defined(TOKENIZER_SSE2)
+    for (; i + blockSize <= size; i += blockSize) {
+        uint spaces;
+        uint special;
+        classifyBlock(units + i, spaces, special);
+
+        if (special == 0) {
+            tokenizer.fastBlock(i, spaces);
+        } else {
+            for (int j = i; j < i + blockSize; j++) {
+                tokenizer.scalar(j);
+            }
+        }
+    }
+#endif
+
+    for (; i < size; i++) {
+        tokenizer.scalar(i);
+    }
+
+    tokenizer.end(size);
+}
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QString>
+
+#include <boost/container/small_vector.hpp>
+
+#include <cstdint>
+
+namespace chatterino {
+namespace util {
+
+// A word of a message, words are separated by spaces
+struct MessageToken {
+    enum Flags : uint8_t {
+        // only ascii, none of the flags below are set
+        None = 0,
+
+        // contains at least one code unit outside of ascii
+        NonAscii = (1 << 0),
+
+        // contains a code unit that every emoji sequence in resources/emojidata.txt has one of,
+        // words without it can't contain an emoji
+        EmojiCandidate = (1 << 1),
+
+        // contains a '.' followed by a letter, a digit or a code unit outside of ascii, or a ':'
+        // followed by a '/', words without it are never links
+        UrlCandidate = (1 << 2),
+    };
+
+    // position in the QString
+    int start;
+    int length;
+
+    // position in code points, what the emotes tag of twitch counts in
+    int codePointStart;
+
+    uint8_t flags;
+
+    bool is(Flags flag) const
+    {
+        return (this->flags & flag) != 0;
+    }
+};
+
+typedef boost::container::small_vector<MessageToken, 32> MessageTokens;
+
+// Splits the text into words in a single pass and classifies them. Runs of spaces are skipped,
+// so there are no empty tokens. Uses AVX2 or SSE2 when the compiler targets them, and a scalar
+// loop otherwise.
+void tokenizeMessage(const QString &text, MessageTokens &tokens);
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,178 @@
+#include "util/symbol.hpp"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace chatterino {
+namespace util {
+
+struct Symbol::Entry {
+    QString string;
+    std::atomic<int> references;
+
+    // index of the shard of the pool the entry is in
+    int shard;
+};
+
+namespace {
+
+const int shardCount = 16;
+
+// the pool is split into shards that each have their own lock, so the parse threads don't wait
+// for each other while interning
+struct Shard {
+    std::mutex mutex;
+    QHash<QString, Symbol::Entry *> entries;
+};
+
+std::array<Shard, shardCount> &getShards()
+{
+    // never destroyed, symbols in static objects may outlive everything else
+    static auto shards = new std::array<Shard, shardCount>;
+
+    return *shards;
+}
+
+Symbol::Entry *acquire(const QString &string)
+{
+    int shardIndex = int(qHash(string) % shardCount);
+    Shard &shard = getShards()[shardIndex];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.entries.find(string);
+
+    if (it != shard.entries.end()) {
+        it.value()->references.fetch_add(1);
+
+        return it.value();
+    }
+
+    auto entry = new Symbol::Entry{string, {1}, shardIndex};
+    shard.entries.insert(string, entry);
+
+    return entry;
+}
+
+void retain(Symbol::Entry *entry)
+{
+    if (entry != nullptr) {
+        entry->references.fetch_add(1);
+    }
+}
+
+void release(Symbol::Entry *entry)
+{
+    if (entry == nullptr) {
+        return;
+    }
+
+    // fast path, this is not the last reference
+    int references = entry->references.load();
+
+    while (references > 1) {
+        if (entry->references.compare_exchange_weak(references, references - 1)) {
+            return;
+        }
+    }
+
+    // dropping the last reference has to be serialized with acquire() since it might hand out
+    // the entry again
+    Shard &shard = getShards()[entry->shard];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (entry->references.fetch_sub(1) == 1) {
+        shard.entries.remove(entry->string);
+        delete entry;
+    }
+}
+
+const QString emptyString;
+
+}  // namespace
+
+Symbol::Symbol(const QString &string)
+{
+    if (!string.isEmpty()) {
+        this->entry = acquire(string);
+    }
+}
+
+Symbol::Symbol(const Symbol &other)
+    : entry(other.entry)
+{
+    retain(this->entry);
+}
+
+Symbol::Symbol(Symbol &&other)
+    : entry(other.entry)
+{
+    other.entry = nullptr;
+}
+
+Symbol::~Symbol()
+{
+    release(this->entry);
+}
+
+Symbol &Symbol::operator=(const Symbol &other)
+{
+    if (this->entry != other.entry) {
+        retain(other.entry);
+        release(this->entry);
+
+        this->entry = other.entry;
+    }
+
+    return *this;
+}
+
+Symbol &Symbol::operator=(Symbol &&other)
+{
+    if (this != &other) {
+        release(this->entry);
+
+        this->entry = other.entry;
+        other.entry = nullptr;
+    }
+
+    return *this;
+}
+
+const QString &Symbol::toString() const
+{
+    return this->entry != nullptr ? this->entry->string : emptyString;
+}
+
+Symbol::operator const QString &() const
+{
+    return this->toString();
+}
+
+bool Symbol::isEmpty() const
+{
+    return this->entry == nullptr;
+}
+
+int Symbol::size() const
+{
+    return this->toString().size();
+}
+
+size_t Symbol::getPoolSize()
+{
+    size_t size = 0;
+
+    for (Shard &shard : getShards()) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        size += shard.entries.size();
+    }
+
+    return size;
+}
+
+}  // namespace util
+}  // namespace chatterino
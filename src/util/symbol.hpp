@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+
+namespace chatterino {
+namespace util {
+
+//
+// Handle to an interned string.
+//
+// - all symbols with the same text point to the same entry in the pool, comparing and hashing
+//   symbols only looks at that pointer
+// - the entry is removed from the pool when the last symbol that points to it is destroyed
+// - the empty string doesn't have an entry, a default constructed symbol is empty
+// - symbols can be created, copied and destroyed from any thread
+//
+class Symbol
+{
+public:
+    struct Entry;
+
+    Symbol() = default;
+    explicit Symbol(const QString &string);
+
+    Symbol(const Symbol &other);
+    Symbol(Symbol &&other);
+    ~Symbol();
+
+    Symbol &operator=(const Symbol &other);
+    Symbol &operator=(Symbol &&other);
+
+    const QString &toString() const;
+    operator const QString &() const;
+
+    bool isEmpty() const;
+    int size() const;
+
+    bool operator==(const Symbol &other) const
+    {
+        return this->entry == other.entry;
+    }
+
+    bool operator!=(const Symbol &other) const
+    {
+        return this->entry != other.entry;
+    }
+
+    // amount of distinct strings that are currently interned
+    static size_t getPoolSize();
+
+private:
+    Entry *entry = nullptr;
+
+    friend uint qHash(const Symbol &symbol, uint seed)
+    {
+        return ::qHash(static_cast<const void *>(symbol.entry), seed);
+    }
+};
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,146 @@
+#include "util/wordwidthcache.hpp"
+
+#include <QHash>
+
+#include <array>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace chatterino {
+namespace util {
+
+namespace {
+
+const int shardCount = 16;
+const size_t wordsPerShard = 4096;
+
+struct Key {
+    int fontGeneration;
+    FontStyle style;
+    float scale;
+    QString word;
+
+    // computed once, used to pick the shard and by the map
+    uint hash;
+
+    bool operator==(const Key &other) const
+    {
+        return this->hash == other.hash && this->fontGeneration == other.fontGeneration &&
+               this->style == other.style && this->scale == other.scale &&
+               this->word == other.word;
+    }
+};
+
+struct KeyHash {
+    size_t operator()(const Key &key) const
+    {
+        return key.hash;
+    }
+};
+
+struct Shard {
+    std::mutex mutex;
+
+    // most recently used first
+    std::list<std::pair<Key, int>> words;
+    std::unordered_map<Key, std::list<std::pair<Key, int>>::iterator, KeyHash> index;
+
+    uint64_t hits = 0;
+    uint64_t lookups = 0;
+};
+
+std::array<Shard, shardCount> &getShards()
+{
+    // never destroyed, layout threads may still measure words while the program exits
+    static auto shards = new std::array<Shard, shardCount>;
+
+    return *shards;
+}
+
+uint hashKey(const QString &word, FontStyle style, float scale, int fontGeneration)
+{
+    uint scaleBits;
+    std::memcpy(&scaleBits, &scale, sizeof(scaleBits));
+
+    uint seed = uint(fontGeneration) * 31u + uint(style);
+    seed = seed * 31u + scaleBits;
+
+    return qHash(word, seed);
+}
+
+}  // namespace
+
+double WordWidthCache::Statistics::getHitRate() const
+{
+    return this->lookups == 0 ? 0 : double(this->hits) / double(this->lookups);
+}
+
+int WordWidthCache::getWidth(const QString &word, FontStyle style, float scale,
+                             int fontGeneration, const QFontMetrics &metrics)
+{
+    Key key{fontGeneration, style, scale, word, hashKey(word, style, scale, fontGeneration)};
+    Shard &shard = getShards()[key.hash % shardCount];
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.lookups++;
+
+        auto it = shard.index.find(key);
+
+        if (it != shard.index.end()) {
+            shard.hits++;
+            shard.words.splice(shard.words.begin(), shard.words, it->second);
+
+            return it->second->second;
+        }
+    }
+
+    // measure without holding the lock, another thread might measure the same word meanwhile
+    int width = metrics.width(word);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (shard.index.find(key) != shard.index.end()) {
+        return width;
+    }
+
+    shard.words.emplace_front(key, width);
+    shard.index.emplace(std::move(key), shard.words.begin());
+
+    if (shard.words.size() > wordsPerShard) {
+        shard.index.erase(shard.words.back().first);
+        shard.words.pop_back();
+    }
+
+    return width;
+}
+
+void WordWidthCache::clear()
+{
+    for (Shard &shard : getShards()) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.index.clear();
+        shard.words.clear();
+    }
+}
+
+WordWidthCache::Statistics WordWidthCache::getStatistics()
+{
+    Statistics statistics{0, 0};
+
+    for (Shard &shard : getShards()) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        statistics.hits += shard.hits;
+        statistics.lookups += shard.lookups;
+    }
+
+    return statistics;
+}
+
+}  // namespace util
+}  // namespace chatterino
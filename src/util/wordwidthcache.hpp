@@ -0,0 +1,44 @@
+#pragma once
+
+#include "singletons/fontmanager.hpp"
+
+#include <QFontMetrics>
+#include <QString>
+
+#include <cstdint>
+
+namespace chatterino {
+namespace util {
+
+//
+// Advance widths of words, shared by all messages and threads
+//
+// - keyed by the font generation, the font style, the scale and the text of the word
+// - split into shards that each have their own lock and evict their least recently used words
+// - cleared when the font changes, words measured with an older font are never returned
+//
+class WordWidthCache
+{
+public:
+    struct Statistics {
+        uint64_t hits;
+        uint64_t lookups;
+
+        // 0 if nothing was looked up yet
+        double getHitRate() const;
+    };
+
+    // returns the cached width of the word, or measures it with `metrics` and caches it.
+    // `metrics` has to belong to `fontGeneration`, `style` and `scale`.
+    static int getWidth(const QString &word, FontStyle style, float scale, int fontGeneration,
+                        const QFontMetrics &metrics);
+
+    static void clear();
+
+    // counted since the program started, only includes the words that were passed to getWidth.
+    // TextElement measures ascii words with the advance tables of the font instead.
+    static Statistics getStatistics();
+};
+
+}  // namespace util
+}  // namespace chatterino
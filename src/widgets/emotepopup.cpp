@@ -48,7 +48,7 @@ void EmotePopup::loadChannel(SharedChannel _channel)
         // TITLE
         messages::MessageBuilder builder1;
 
-        builder1.appendElement(new TextElement(title, MessageElement::Text));
+        builder1.append<TextElement>(title, MessageElement::Text);
 
         builder1.getMessage()->addFlags(Message::Centered);
         emoteChannel->addMessage(builder1.getMessage());
@@ -59,8 +59,8 @@ void EmotePopup::loadChannel(SharedChannel _channel)
         builder2.getMessage()->addFlags(Message::DisableCompactEmotes);
 
         map.each([&](const QString &key, const util::EmoteData &value) {
-            builder2.appendElement((new EmoteElement(value, MessageElement::Flags::AlwaysShow))  //
-                                       ->setLink(Link(Link::InsertText, key)));
+            builder2.append<EmoteElement>(value, MessageElement::Flags::AlwaysShow)
+                ->setLink(Link(Link::InsertText, key));
         });
 
         emoteChannel->addMessage(builder2.getMessage());
@@ -88,7 +88,7 @@ void EmotePopup::loadEmojis()
     // title
     messages::MessageBuilder builder1;
 
-    builder1.appendElement(new TextElement("emojis", MessageElement::Text));
+    builder1.append<TextElement>("emojis", MessageElement::Text);
     builder1.getMessage()->addFlags(Message::Centered);
     emojiChannel->addMessage(builder1.getMessage());
 
@@ -98,8 +98,8 @@ void EmotePopup::loadEmojis()
     builder.getMessage()->setFlags(Message::DisableCompactEmotes);
 
     emojis.each([this, &builder](const QString &key, const util::EmoteData &value) {
-        builder.appendElement((new EmoteElement(value, MessageElement::Flags::AlwaysShow))  //
-                                  ->setLink(Link(Link::Type::InsertText, key)));
+        builder.append<EmoteElement>(value, MessageElement::Flags::AlwaysShow)
+            ->setLink(Link(Link::Type::InsertText, key));
     });
     emojiChannel->addMessage(builder.getMessage());
 
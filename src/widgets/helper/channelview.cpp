@@ -1,9 +1,11 @@
 #include "channelview.hpp"
 #include "debug/log.hpp"
 #include "messages/layouts/messagelayout.hpp"
+#include "messages/layouts/messagelayoutengine.hpp"
 #include "messages/limitedqueuesnapshot.hpp"
 #include "messages/message.hpp"
 #include "singletons/channelmanager.hpp"
+#include "singletons/scrollbackmanager.hpp"
 #include "singletons/settingsmanager.hpp"
 #include "singletons/thememanager.hpp"
 #include "singletons/windowmanager.hpp"
@@ -17,6 +19,7 @@
 #include <QDesktopServices>
 #include <QGraphicsBlurEffect>
 #include <QPainter>
+#include <QPointer>
 
 #include <math.h>
 #include <algorithm>
@@ -32,6 +35,14 @@ using namespace chatterino::messages;
 namespace chatterino {
 namespace widgets {
 
+namespace {
+
+// amount of messages restored from the cold storage at once
+const size_t olderMessagesPageSize = 50;
+const size_t maxOlderMessages = 10000;
+
+}  // namespace
+
 ChannelView::ChannelView(BaseWidget *parent)
     : BaseWidget(parent)
     , scrollBar(this)
@@ -47,6 +58,13 @@ ChannelView::ChannelView(BaseWidget *parent)
                      &ChannelView::wordTypeMaskChanged);
 
     this->scrollBar.getCurrentValueChanged().connect([this] {
+        // page in older messages when scrolled to the top and drop them again at the bottom
+        if (this->scrollBar.isVisible() && this->scrollBar.getCurrentValue() < 1) {
+            this->loadOlderMessages();
+        } else if (this->olderMessageCount > 0 && this->scrollBar.isAtBottom()) {
+            this->unloadOlderMessages();
+        }
+
         // Whenever the scrollbar value has been changed, re-render the ChatWidgetView
         this->layoutMessages();
         this->goToBottom->setVisible(this->enableScrollingToBottom && this->scrollBar.isVisible() &&
@@ -63,6 +81,12 @@ ChannelView::ChannelView(BaseWidget *parent)
             this->layoutMessages();
         }
     });
+    this->scrollToMessageConnection =
+        windowManager.scrollToMessage.connect([&](Channel *channel, const QString &messageId) {
+            if (this->channel.get() == channel) {
+                this->scrollToMessage(messageId);
+            }
+        });
 
     this->goToBottom = new RippleEffectLabel(this, 0);
     this->goToBottom->setStyleSheet("background-color: rgba(0,0,0,0.66); color: #FFF;");
@@ -74,6 +98,11 @@ ChannelView::ChannelView(BaseWidget *parent)
             this->layoutMessages();  //
         }));
 
+    this->managedConnections.emplace_back(
+        messages::layouts::MessageLayoutEngine::getInstance().layoutsFinished.connect([this] {
+            this->layoutMessages();  //
+        }));
+
     connect(goToBottom, &RippleEffectLabel::clicked, this, [this] {
         QTimer::singleShot(180, [this] {
             this->scrollBar.scrollToBottom(singletons::SettingManager::getInstance()
@@ -92,6 +121,8 @@ ChannelView::ChannelView(BaseWidget *parent)
     });
 
     this->pauseTimeout.setSingleShot(true);
+
+    singletons::ScrollbackManager::getInstance().addView(this);
 }
 
 ChannelView::~ChannelView()
@@ -100,11 +131,15 @@ ChannelView::~ChannelView()
                         &singletons::SettingManager::wordTypeMaskChanged, this,
                         &ChannelView::wordTypeMaskChanged);
     this->messageAppendedConnection.disconnect();
-    this->messageRemovedConnection.disconnect();
     this->repaintGifsConnection.disconnect();
     this->layoutConnection.disconnect();
+    this->scrollToMessageConnection.disconnect();
     this->messageAddedAtStartConnection.disconnect();
     this->messageReplacedConnection.disconnect();
+    this->messageLimitChangedConnection.disconnect();
+    this->messagesDisabledConnection.disconnect();
+
+    singletons::ScrollbackManager::getInstance().removeView(this);
 }
 
 void ChannelView::queueUpdate()
@@ -370,28 +405,52 @@ void ChannelView::setChannel(SharedChannel newChannel)
     }
     this->messages.clear();
 
-    // on new message
+    // on new messages
     this->messageAppendedConnection =
-        newChannel->messageAppended.connect([this](MessagePtr &message) {
-            MessageLayoutPtr deleted;
+        newChannel->messagesAppended.connect([this](std::vector<MessagePtr> &messages) {
+            std::vector<MessageLayoutPtr> messageRefs;
+            std::vector<ScrollbarHighlight> highlights;
+            messageRefs.reserve(messages.size());
+            highlights.reserve(messages.size());
 
-            auto messageRef = new MessageLayout(message);
+            bool triggerNotification = false;
+
+            for (const MessagePtr &message : messages) {
+                messageRefs.push_back(MessageLayoutPtr(new MessageLayout(message)));
+                highlights.push_back(message->getScrollBarHighlight());
+
+                triggerNotification |= !message->hasFlags(Message::DoNotTriggerNotification);
+            }
+
+            // keep the older messages while the user is reading them
+            if (this->olderMessageCount > 0 && this->olderMessageCount < maxOlderMessages) {
+                this->olderMessageCount =
+                    std::min(maxOlderMessages, this->olderMessageCount + messages.size());
+                this->applyMessageLimit(this->channel->getMessageLimit());
+            }
+
+            int removed = (int)this->messages.pushBack(messageRefs).size();
+
+            if (removed > 0) {
+                this->selection.min.messageIndex -= removed;
+                this->selection.max.messageIndex -= removed;
+                this->selection.start.messageIndex -= removed;
+                this->selection.end.messageIndex -= removed;
 
-            if (this->messages.pushBack(MessageLayoutPtr(messageRef), deleted)) {
                 if (!this->paused) {
                     if (this->scrollBar.isAtBottom()) {
                         this->scrollBar.scrollToBottom();
                     } else {
-                        this->scrollBar.offset(-1);
+                        this->scrollBar.offset(-(qreal)removed);
                     }
                 }
             }
 
-            if (!message->hasFlags(Message::DoNotTriggerNotification)) {
+            if (triggerNotification) {
                 this->highlightedMessageReceived.invoke();
             }
 
-            this->scrollBar.addHighlight(message->getScrollBarHighlight());
+            this->scrollBar.addHighlights(highlights);
 
             this->messageWasAdded = true;
             this->layoutMessages();
@@ -428,34 +487,54 @@ void ChannelView::setChannel(SharedChannel newChannel)
             this->layoutMessages();
         });
 
-    // on message removed
-    this->messageRemovedConnection =
-        newChannel->messageRemovedFromStart.connect([this](MessagePtr &) {
-            this->selection.min.messageIndex--;
-            this->selection.max.messageIndex--;
-            this->selection.start.messageIndex--;
-            this->selection.end.messageIndex--;
-
-            this->layoutMessages();
-        });
-
     // on message replaced
     this->messageReplacedConnection =
         newChannel->messageReplaced.connect([this](size_t index, MessagePtr replacement) {
             MessageLayoutPtr newItem(new MessageLayout(replacement));
 
+            index += this->getViewIndexOffset();
+
             this->scrollBar.replaceHighlight(index, replacement->getScrollBarHighlight());
 
-            this->messages.replaceItem(this->messages.getSnapshot()[index], newItem);
+            this->messages.replaceItem(index, newItem);
             this->layoutMessages();
         });
 
+    // on message limit changed
+    this->messageLimitChangedConnection =
+        newChannel->messageLimitChanged.connect([this](size_t limit) {
+            this->applyMessageLimit(limit);  //
+        });
+
+    // on messages disabled
+    this->messagesDisabledConnection = newChannel->messagesDisabled.connect(
+        [this](const std::vector<MessagePtr> &messages) {
+            // disabled messages only get an overlay when painted, no layout needed
+            std::unordered_set<const Message *> disabled;
+            for (const MessagePtr &message : messages) {
+                disabled.insert(message.get());
+            }
+
+            for (const MessageLayoutPtr &layout : this->messagesOnScreen) {
+                if (disabled.count(layout->getMessage()) != 0) {
+                    this->queueUpdate();
+                    return;
+                }
+            }
+        });
+
+    this->olderMessageCount = 0;
+    this->olderMessagesRequest++;
+    this->loadingOlderMessages = false;
+    this->olderMessagesExhausted = false;
+    this->applyMessageLimit(newChannel->getMessageLimit());
+
     auto snapshot = newChannel->getMessageSnapshot();
 
-    for (size_t i = 0; i < snapshot.getLength(); i++) {
+    for (const MessagePtr &message : snapshot) {
         MessageLayoutPtr deleted;
 
-        auto messageRef = new MessageLayout(snapshot[i]);
+        auto messageRef = new MessageLayout(message);
 
         this->messages.pushBack(MessageLayoutPtr(messageRef), deleted);
     }
@@ -467,13 +546,179 @@ void ChannelView::setChannel(SharedChannel newChannel)
     this->queueUpdate();
 }
 
+const SharedChannel &ChannelView::getChannel() const
+{
+    return this->channel;
+}
+
+void ChannelView::scrollToMessage(const QString &messageId)
+{
+    if (!this->channel) {
+        return;
+    }
+
+    int index = this->channel->findMessageIndex(messageId);
+
+    if (index < 0) {
+        return;
+    }
+
+    this->scrollBar.setDesiredValue(index + this->getViewIndexOffset(), true);
+}
+
+// the view and the channel always end with the same messages, but the view might have older
+// messages at the start
+int ChannelView::getViewIndexOffset()
+{
+    return std::max(0, (int)this->messages.getSnapshot().getLength() -
+                           (int)this->channel->getMessageSnapshot().getLength());
+}
+
 void ChannelView::detachChannel()
 {
     // on message added
     this->messageAppendedConnection.disconnect();
+    this->messageAddedAtStartConnection.disconnect();
 
-    // on message removed
-    this->messageRemovedConnection.disconnect();
+    this->messageReplacedConnection.disconnect();
+    this->messageLimitChangedConnection.disconnect();
+    this->messagesDisabledConnection.disconnect();
+}
+
+void ChannelView::applyMessageLimit(size_t limit)
+{
+    limit += this->olderMessageCount;
+
+    this->scrollBar.setHighlightLimit(limit);
+
+    int removed = (int)this->messages.setLimit(limit).size();
+
+    if (removed == 0) {
+        return;
+    }
+
+    this->selection.min.messageIndex -= removed;
+    this->selection.max.messageIndex -= removed;
+    this->selection.start.messageIndex -= removed;
+    this->selection.end.messageIndex -= removed;
+
+    if (!this->scrollBar.isAtBottom()) {
+        this->scrollBar.offset(-(qreal)removed);
+    }
+
+    this->layoutMessages();
+}
+
+void ChannelView::loadOlderMessages()
+{
+    // the scrollbar keeps reporting the top until the requested page arrived
+    if (!this->channel || !this->channel->hasColdStorage() || this->loadingOlderMessages) {
+        return;
+    }
+
+    uint64_t coldMessagesEnd = this->channel->getColdMessagesEnd();
+
+    // once the oldest stored message was loaded, only messages that are evicted later can be
+    // loaded, and only when the view starts where the channel starts again
+    if (this->olderMessagesExhausted) {
+        if (this->olderMessageCount > 0 || coldMessagesEnd == this->exhaustedColdMessagesEnd) {
+            return;
+        }
+
+        this->olderMessagesExhausted = false;
+    }
+
+    // without older messages the view starts where the channel starts
+    if (this->olderMessageCount == 0) {
+        this->coldMessageCursor = coldMessagesEnd;
+    }
+
+    size_t count = std::min(olderMessagesPageSize, maxOlderMessages - this->olderMessageCount);
+
+    if (count == 0) {
+        return;
+    }
+
+    this->loadingOlderMessages = true;
+
+    QPointer<ChannelView> self(this);
+    uint64_t request = this->olderMessagesRequest;
+
+    this->channel->loadColdMessages(
+        this->coldMessageCursor, count,
+        [self, request, coldMessagesEnd](uint64_t cursor, std::vector<MessagePtr> &messages,
+                                         bool exhausted) {
+            // ignore pages of a previous channel or of older messages that were unloaded since
+            if (self.isNull() || self->olderMessagesRequest != request) {
+                return;
+            }
+
+            self->loadingOlderMessages = false;
+            self->coldMessageCursor = cursor;
+
+            if (exhausted || messages.empty()) {
+                self->olderMessagesExhausted = true;
+                self->exhaustedColdMessagesEnd = coldMessagesEnd;
+            }
+            self->addOlderMessages(messages);
+        });
+}
+
+void ChannelView::addOlderMessages(std::vector<MessagePtr> &messages)
+{
+    if (messages.empty()) {
+        return;
+    }
+
+    this->olderMessageCount += messages.size();
+    this->applyMessageLimit(this->channel->getMessageLimit());
+
+    std::vector<MessageLayoutPtr> messageRefs;
+    std::vector<ScrollbarHighlight> highlights;
+    messageRefs.reserve(messages.size());
+    highlights.reserve(messages.size());
+
+    for (const MessagePtr &message : messages) {
+        messageRefs.push_back(MessageLayoutPtr(new MessageLayout(message)));
+        highlights.push_back(message->getScrollBarHighlight());
+    }
+
+    int added = (int)this->messages.pushFront(messageRefs).size();
+    this->scrollBar.addHighlightsAtStart(highlights);
+
+    this->selection.min.messageIndex += added;
+    this->selection.max.messageIndex += added;
+    this->selection.start.messageIndex += added;
+    this->selection.end.messageIndex += added;
+
+    // keep the same messages on screen
+    this->scrollBar.offset((qreal)added);
+
+    this->layoutMessages();
+}
+
+void ChannelView::unloadOlderMessages()
+{
+    this->olderMessageCount = 0;
+    this->olderMessagesRequest++;
+    this->loadingOlderMessages = false;
+    // the unloaded messages can be loaded again
+    this->olderMessagesExhausted = false;
+
+    if (this->channel) {
+        this->applyMessageLimit(this->channel->getMessageLimit());
+    }
+}
+
+size_t ChannelView::getApproximateLayoutsSize()
+{
+    size_t size = 0;
+
+    for (const MessageLayoutPtr &layout : this->messages.getSnapshot()) {
+        size += layout->getApproximateSize();
+    }
+
+    return size;
 }
 
 void ChannelView::pause(int msecTimeout)
@@ -978,6 +1223,19 @@ void ChannelView::mouseReleaseEvent(QMouseEvent *event)
             QDesktopServices::openUrl(QUrl(link.getValue()));
             break;
         }
+        case messages::Link::ShowMessage: {
+            // value is "<channel name>\n<message id>"
+            QStringList parts = link.getValue().split('\n');
+
+            if (parts.size() == 2) {
+                auto channel = singletons::ChannelManager::getInstance().getTwitchChannel(parts[0]);
+
+                if (channel) {
+                    singletons::WindowManager::getInstance().showMessage(channel.get(), parts[1]);
+                }
+            }
+            break;
+        }
     }
 }
 
@@ -41,11 +41,16 @@ public:
     void pause(int msecTimeout);
 
     void setChannel(SharedChannel channel);
+    const SharedChannel &getChannel() const;
+    void scrollToMessage(const QString &messageId);
     messages::LimitedQueueSnapshot<messages::MessageLayoutPtr> getMessagesSnapshot();
     void layoutMessages();
 
     void clearMessages();
 
+    // approximate amount of bytes used by the message layouts and their buffers
+    size_t getApproximateLayoutsSize();
+
     boost::signals2::signal<void(QMouseEvent *)> mouseDown;
     boost::signals2::signal<void()> selectionChanged;
     pajlada::Signals::NoArgSignal highlightedMessageReceived;
@@ -76,6 +81,11 @@ private:
     messages::LimitedQueueSnapshot<messages::MessageLayoutPtr> snapshot;
 
     void detachChannel();
+    void applyMessageLimit(size_t limit);
+    void loadOlderMessages();
+    void addOlderMessages(std::vector<messages::MessagePtr> &messages);
+    void unloadOlderMessages();
+    int getViewIndexOffset();
     void actuallyLayoutMessages();
 
     void drawMessages(QPainter &painter);
@@ -103,12 +113,27 @@ private:
 
     messages::LimitedQueue<messages::MessageLayoutPtr> messages;
 
+    // messages restored from the channels cold storage are kept in addition to the channels
+    // message limit until the view is scrolled to the bottom again
+    size_t olderMessageCount = 0;
+    uint64_t coldMessageCursor = 0;
+    // older messages are restored in the background, one page at a time. Pages of an older
+    // request are dropped.
+    bool loadingOlderMessages = false;
+    uint64_t olderMessagesRequest = 0;
+    // set once the oldest stored message was loaded, together with the end of the cold storage
+    // at that time
+    bool olderMessagesExhausted = false;
+    uint64_t exhaustedColdMessagesEnd = 0;
+
     boost::signals2::connection messageAppendedConnection;
     boost::signals2::connection messageAddedAtStartConnection;
-    boost::signals2::connection messageRemovedConnection;
     boost::signals2::connection messageReplacedConnection;
+    boost::signals2::connection messageLimitChangedConnection;
+    boost::signals2::connection messagesDisabledConnection;
     boost::signals2::connection repaintGifsConnection;
     boost::signals2::connection layoutConnection;
+    boost::signals2::connection scrollToMessageConnection;
 
     std::vector<pajlada::Signals::ScopedConnection> managedConnections;
 
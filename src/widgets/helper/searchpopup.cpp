@@ -4,6 +4,8 @@
 #include <QLineEdit>
 #include <QVBoxLayout>
 
+#include <algorithm>
+
 #include "channel.hpp"
 #include "widgets/helper/channelview.hpp"
 
@@ -73,6 +75,9 @@ void SearchPopup::performSearch()
 
     SharedChannel channel(new Channel("search"));
 
+    // not managed by the ScrollbackManager, make room for every message that could match
+    channel->setMessageLimit(std::max(channel->getMessageLimit(), this->snapshot.getLength()));
+
     for (size_t i = 0; i < this->snapshot.getLength(); i++) {
         messages::MessagePtr message = this->snapshot[i];
 
@@ -42,6 +42,11 @@ void Scrollbar::addHighlight(ScrollbarHighlight highlight)
     this->highlights.pushBack(highlight, deleted);
 }
 
+void Scrollbar::addHighlights(const std::vector<ScrollbarHighlight> &_highlights)
+{
+    this->highlights.pushBack(_highlights);
+}
+
 void Scrollbar::addHighlightsAtStart(const std::vector<ScrollbarHighlight> &_highlights)
 {
     this->highlights.pushFront(_highlights);
@@ -52,6 +57,11 @@ void Scrollbar::replaceHighlight(size_t index, ScrollbarHighlight replacement)
     this->highlights.replaceItem(index, replacement);
 }
 
+void Scrollbar::setHighlightLimit(size_t limit)
+{
+    this->highlights.setLimit(limit);
+}
+
 void Scrollbar::scrollToBottom(bool animate)
 {
     this->setDesiredValue(this->maximum - this->getLargeChange(), animate);
@@ -24,8 +24,10 @@ public:
     Scrollbar(ChannelView *parent = 0);
 
     void addHighlight(ScrollbarHighlight highlight);
+    void addHighlights(const std::vector<ScrollbarHighlight> &highlights);
     void addHighlightsAtStart(const std::vector<ScrollbarHighlight> &highlights);
     void replaceHighlight(size_t index, ScrollbarHighlight replacement);
+    void setHighlightLimit(size_t limit);
 
     void scrollToBottom(bool animate = false);
     bool isAtBottom() const;
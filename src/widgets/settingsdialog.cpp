@@ -9,6 +9,7 @@
 #include "widgets/settingspages/emotespage.hpp"
 #include "widgets/settingspages/highlightingpage.hpp"
 #include "widgets/settingspages/logspage.hpp"
+#include "widgets/settingspages/memorypage.hpp"
 #include "widgets/settingspages/moderationpage.hpp"
 
 #include <QDialogButtonBox>
@@ -82,6 +83,7 @@ void SettingsDialog::addTabs()
     this->addTab(new settingspages::HighlightingPage);
     //    this->addTab(new settingspages::LogsPage);
     this->addTab(new settingspages::ModerationPage);
+    this->addTab(new settingspages::MemoryPage);
     this->ui.tabContainer->addStretch(1);
     this->addTab(new settingspages::AboutPage, Qt::AlignBottom);
 }
@@ -113,6 +113,8 @@ void HighlightingPage::addHighlightTabSignals()
 
         auto sound = new QCheckBox("Play sound");
         auto task = new QCheckBox("Flash taskbar");
+        auto wholeWord = new QCheckBox("Whole word only");
+        auto regex = new QCheckBox("Regular expression");
 
         // Save highlight
         QObject::connect(add, &QPushButton::clicked, this, [=, &settings] {
@@ -126,6 +128,8 @@ void HighlightingPage::addHighlightTabSignals()
                 newHighlightProperty.key = highlightKey;
                 newHighlightProperty.sound = sound->isChecked();
                 newHighlightProperty.alert = task->isChecked();
+                newHighlightProperty.wholeWord = wholeWord->isChecked();
+                newHighlightProperty.regex = regex->isChecked();
 
                 properties.push_back(newHighlightProperty);
 
@@ -138,6 +142,8 @@ void HighlightingPage::addHighlightTabSignals()
         box->addWidget(add);
         box->addWidget(sound);
         box->addWidget(task);
+        box->addWidget(wholeWord);
+        box->addWidget(regex);
         show->setLayout(box);
         show->show();
     });
@@ -175,6 +181,10 @@ void HighlightingPage::addHighlightTabSignals()
         sound->setChecked(selectedSetting.sound);
         auto task = new QCheckBox("Flash taskbar");
         task->setChecked(selectedSetting.alert);
+        auto wholeWord = new QCheckBox("Whole word only");
+        wholeWord->setChecked(selectedSetting.wholeWord);
+        auto regex = new QCheckBox("Regular expression");
+        regex->setChecked(selectedSetting.regex);
 
         // Apply edited changes
         QObject::connect(apply, &QPushButton::clicked, this, [=, &settings] {
@@ -200,6 +210,8 @@ void HighlightingPage::addHighlightTabSignals()
             highlightProperty.key = newHighlightKey;
             highlightProperty.sound = sound->isCheckable();
             highlightProperty.alert = task->isCheckable();
+            highlightProperty.wholeWord = wholeWord->isChecked();
+            highlightProperty.regex = regex->isChecked();
 
             settings.highlightProperties = properties;
 
@@ -213,6 +225,8 @@ void HighlightingPage::addHighlightTabSignals()
         box->addWidget(apply);
         box->addWidget(sound);
         box->addWidget(task);
+        box->addWidget(wholeWord);
+        box->addWidget(regex);
         show->setLayout(box);
         show->show();
     });
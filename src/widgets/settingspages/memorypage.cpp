@@ -0,0 +1,107 @@
+#include "memorypage.hpp"
+
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include "singletons/scrollbackmanager.hpp"
+#include "util/layoutcreator.hpp"
+#include "util/wordwidthcache.hpp"
+
+namespace chatterino {
+namespace widgets {
+namespace settingspages {
+
+MemoryPage::MemoryPage()
+    : SettingsPage("Memory", "")
+{
+    singletons::SettingManager &settings = singletons::SettingManager::getInstance();
+    singletons::ScrollbackManager &scrollbackManager =
+        singletons::ScrollbackManager::getInstance();
+    util::LayoutCreator<MemoryPage> layoutCreator(this);
+
+    auto layout = layoutCreator.emplace<QVBoxLayout>().withoutMargin();
+    {
+        auto form = layout.emplace<QFormLayout>();
+        {
+            auto budget = new QSpinBox;
+            budget->setRange(16, 4096);
+            budget->setSuffix(" MB");
+            budget->setValue(settings.scrollbackMemoryBudget);
+
+            QObject::connect(budget, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+                             [&settings](int value) {
+                                 settings.scrollbackMemoryBudget = value;  //
+                             });
+
+            form->addRow("Scrollback budget:", budget);
+
+            this->totalLabel = new QLabel;
+            form->addRow("Currently used:", this->totalLabel);
+
+            this->wordWidthCacheLabel = new QLabel;
+            form->addRow("Word width cache (non-ASCII words):", this->wordWidthCacheLabel);
+        }
+
+        auto table = layout.emplace<QTableWidget>(0, 5).getElement();
+        table->setHorizontalHeaderLabels({"Channel", "Messages", "Limit", "Size", "Activity"});
+        table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        table->verticalHeader()->hide();
+        table->horizontalHeader()->setStretchLastSection(true);
+        this->channelTable = table;
+    }
+
+    this->managedConnections.emplace_back(scrollbackManager.rebalanced.connect([this] {
+        this->updateChannels();  //
+    }));
+
+    this->updateChannels();
+}
+
+void MemoryPage::updateChannels()
+{
+    singletons::ScrollbackManager &scrollbackManager =
+        singletons::ScrollbackManager::getInstance();
+
+    auto kilobytes = [](size_t bytes) { return QString::number(bytes / 1024) + " KB"; };
+
+    this->totalLabel->setText(kilobytes(scrollbackManager.getApproximateTotalSize()) + " of " +
+                              kilobytes(scrollbackManager.getBudget()));
+
+    // ascii words are measured with the advance tables and never look up the cache
+    util::WordWidthCache::Statistics statistics = util::WordWidthCache::getStatistics();
+
+    this->wordWidthCacheLabel->setText(QString::number(statistics.getHitRate() * 100, 'f', 1) +
+                                       "% hits of " + QString::number(statistics.lookups) +
+                                       " lookups");
+
+    std::vector<singletons::ScrollbackManager::ChannelInfo> infos =
+        scrollbackManager.getChannelInfos();
+
+    this->channelTable->setRowCount((int)infos.size());
+
+    for (int i = 0; i < (int)infos.size(); i++) {
+        const auto &info = infos[i];
+
+        QString name = info.name.isEmpty() ? "<empty>" : info.name;
+        if (info.visible) {
+            name += " (visible)";
+        }
+
+        this->channelTable->setItem(i, 0, new QTableWidgetItem(name));
+        this->channelTable->setItem(
+            i, 1, new QTableWidgetItem(QString::number(info.messageCount)));
+        this->channelTable->setItem(
+            i, 2, new QTableWidgetItem(QString::number(info.messageLimit)));
+        this->channelTable->setItem(i, 3, new QTableWidgetItem(kilobytes(info.approximateSize)));
+        this->channelTable->setItem(
+            i, 4, new QTableWidgetItem(QString::number(info.activity, 'f', 1)));
+    }
+}
+
+}  // namespace settingspages
+}  // namespace widgets
+}  // namespace chatterino
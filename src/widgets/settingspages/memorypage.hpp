@@ -0,0 +1,27 @@
+#pragma once
+
+#include "widgets/settingspages/settingspage.hpp"
+
+class QLabel;
+class QTableWidget;
+
+namespace chatterino {
+namespace widgets {
+namespace settingspages {
+
+class MemoryPage : public SettingsPage
+{
+public:
+    MemoryPage();
+
+private:
+    void updateChannels();
+
+    QLabel *totalLabel;
+    QLabel *wordWidthCacheLabel;
+    QTableWidget *channelTable;
+};
+
+}  // namespace settingspages
+}  // namespace widgets
+}  // namespace chatterino